@@ -0,0 +1,197 @@
+/*
+ * b2ThreadPool.cpp
+ *
+ * @author  ESL Team
+ * @date    2026-10-16
+ */
+
+#include <Box2D/Common/b2ThreadPool.h>
+#include <Box2D/Common/b2Math.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	// The chunks [head, tail) a thread still has to run. The owner takes
+	// from the head, thieves from the tail.
+	struct b2ChunkQueue
+	{
+		std::mutex lock;
+		int32 head;
+		int32 tail;
+	};
+}
+
+struct b2ThreadPool::Shared
+{
+	std::vector<std::thread> threads;
+	std::vector<b2ChunkQueue> queues;
+
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable done;
+	uint32 generation;
+	int32 pending;
+	bool quit;
+
+	b2ParallelTask* task;
+	void* context;
+	int32 count;
+	int32 grain;
+
+	explicit Shared(int32 threadCount) : queues(threadCount)
+	{
+		generation = 0;
+		pending = 0;
+		quit = false;
+		task = NULL;
+		context = NULL;
+		count = 0;
+		grain = 1;
+	}
+};
+
+b2ThreadPool::b2ThreadPool(int32 threadCount)
+{
+	if (threadCount <= 0)
+	{
+		threadCount = int32(std::thread::hardware_concurrency());
+	}
+	m_threadCount = b2Max(threadCount, 1);
+	m_shared = new Shared(m_threadCount);
+
+	// Thread 0 is whoever calls ParallelFor.
+	for (int32 i = 1; i < m_threadCount; ++i)
+	{
+		m_shared->threads.push_back(std::thread(&b2ThreadPool::WorkerMain, this, i));
+	}
+}
+
+b2ThreadPool::~b2ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> guard(m_shared->mutex);
+		m_shared->quit = true;
+	}
+	m_shared->wake.notify_all();
+	for (size_t i = 0; i < m_shared->threads.size(); ++i)
+	{
+		m_shared->threads[i].join();
+	}
+	delete m_shared;
+}
+
+void b2ThreadPool::ParallelFor(int32 count, int32 grain, b2ParallelTask* task, void* context)
+{
+	if (count <= 0)
+	{
+		return;
+	}
+
+	grain = b2Max(grain, 1);
+	int32 chunkCount = (count + grain - 1) / grain;
+	if (m_threadCount == 1 || chunkCount == 1)
+	{
+		task(context, 0, count, 0);
+		return;
+	}
+
+	Shared& s = *m_shared;
+	s.task = task;
+	s.context = context;
+	s.count = count;
+	s.grain = grain;
+
+	// Deal the chunks out evenly; stealing evens out the rest.
+	for (int32 i = 0; i < m_threadCount; ++i)
+	{
+		b2ChunkQueue& q = s.queues[i];
+		std::lock_guard<std::mutex> guard(q.lock);
+		q.head = chunkCount * i / m_threadCount;
+		q.tail = chunkCount * (i + 1) / m_threadCount;
+	}
+
+	{
+		std::lock_guard<std::mutex> guard(s.mutex);
+		s.pending = m_threadCount - 1;
+		++s.generation;
+	}
+	s.wake.notify_all();
+
+	RunChunks(0);
+
+	std::unique_lock<std::mutex> lock(s.mutex);
+	while (s.pending > 0)
+	{
+		s.done.wait(lock);
+	}
+}
+
+void b2ThreadPool::WorkerMain(int32 threadIndex)
+{
+	Shared& s = *m_shared;
+	uint32 seen = 0;
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(s.mutex);
+			while (s.quit == false && s.generation == seen)
+			{
+				s.wake.wait(lock);
+			}
+			if (s.quit)
+			{
+				return;
+			}
+			seen = s.generation;
+		}
+
+		RunChunks(threadIndex);
+
+		std::lock_guard<std::mutex> guard(s.mutex);
+		if (--s.pending == 0)
+		{
+			s.done.notify_one();
+		}
+	}
+}
+
+void b2ThreadPool::RunChunks(int32 threadIndex)
+{
+	Shared& s = *m_shared;
+	int32 chunk;
+	while (TakeChunk(threadIndex, &chunk))
+	{
+		int32 begin = chunk * s.grain;
+		int32 end = b2Min(begin + s.grain, s.count);
+		s.task(s.context, begin, end, threadIndex);
+	}
+}
+
+bool b2ThreadPool::TakeChunk(int32 threadIndex, int32* chunk)
+{
+	Shared& s = *m_shared;
+	{
+		b2ChunkQueue& own = s.queues[threadIndex];
+		std::lock_guard<std::mutex> guard(own.lock);
+		if (own.head < own.tail)
+		{
+			*chunk = own.head++;
+			return true;
+		}
+	}
+
+	for (int32 i = 1; i < m_threadCount; ++i)
+	{
+		b2ChunkQueue& victim = s.queues[(threadIndex + i) % m_threadCount];
+		std::lock_guard<std::mutex> guard(victim.lock);
+		if (victim.head < victim.tail)
+		{
+			*chunk = --victim.tail;
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,53 @@
+/*
+ * b2ThreadPool.h
+ *
+ * Worker threads for b2World, added to the vendored Box2D for parallel
+ * island solving. Not part of upstream Box2D.
+ *
+ * @author  ESL Team
+ * @date    2026-10-16
+ */
+
+#ifndef B2_THREAD_POOL_H
+#define B2_THREAD_POOL_H
+
+#include <Box2D/Common/b2Settings.h>
+
+/// A task run by b2ThreadPool::ParallelFor over the items [begin, end).
+/// threadIndex is in [0, GetThreadCount()) and is 0 for the calling thread,
+/// so it can index per-thread scratch such as stack allocators.
+typedef void b2ParallelTask(void* context, int32 begin, int32 end, int32 threadIndex);
+
+/// A fixed set of worker threads for splitting a step's work across cores.
+/// Each thread owns a deque of item ranges; it takes work from the front of
+/// its own and, when that runs dry, steals from the back of the others.
+class b2ThreadPool
+{
+public:
+	/// @param threadCount threads including the caller; 0 uses one per core.
+	explicit b2ThreadPool(int32 threadCount = 0);
+	~b2ThreadPool();
+
+	/// Threads that take part in ParallelFor, including the caller.
+	int32 GetThreadCount() const { return m_threadCount; }
+
+	/// Run task over [0, count) in chunks of at most grain items and return
+	/// when all are done. Small jobs run inline on the calling thread.
+	/// Not reentrant: do not call from inside a task.
+	void ParallelFor(int32 count, int32 grain, b2ParallelTask* task, void* context);
+
+private:
+	struct Shared;
+
+	b2ThreadPool(const b2ThreadPool&);
+	b2ThreadPool& operator=(const b2ThreadPool&);
+
+	void WorkerMain(int32 threadIndex);
+	void RunChunks(int32 threadIndex);
+	bool TakeChunk(int32 threadIndex, int32* chunk);
+
+	Shared* m_shared;
+	int32 m_threadCount;
+};
+
+#endif
@@ -189,6 +189,13 @@ protected:
 
 	void Update(b2ContactListener* listener);
 
+	// Update in two halves, for the parallel narrowphase. UpdateManifold
+	// only writes this contact, so contacts can run it concurrently; it
+	// returns whether the contact was touching before. ReportUpdate wakes
+	// the bodies and calls the listener, on the stepping thread.
+	bool UpdateManifold(b2Manifold* oldManifold);
+	void ReportUpdate(bool wasTouching, const b2Manifold* oldManifold, b2ContactListener* listener);
+
 	static b2ContactRegister s_registers[b2Shape::e_typeCount][b2Shape::e_typeCount];
 	static bool s_initialized;
 
@@ -21,6 +21,7 @@
 #include <Box2D/Dynamics/b2Fixture.h>
 #include <Box2D/Dynamics/b2WorldCallbacks.h>
 #include <Box2D/Dynamics/Contacts/b2Contact.h>
+#include <Box2D/Common/b2ThreadPool.h>
 
 b2ContactFilter b2_defaultFilter;
 b2ContactListener b2_defaultListener;
@@ -32,6 +33,14 @@ b2ContactManager::b2ContactManager()
 	m_contactFilter = &b2_defaultFilter;
 	m_contactListener = &b2_defaultListener;
 	m_allocator = NULL;
+	m_threadPool = NULL;
+	m_updateBuffer = NULL;
+	m_updateCapacity = 0;
+}
+
+b2ContactManager::~b2ContactManager()
+{
+	b2Free(m_updateBuffer);
 }
 
 void b2ContactManager::Destroy(b2Contact* c)
@@ -104,6 +113,17 @@ void b2ContactManager::Destroy(b2Contact* c)
 // contact list.
 void b2ContactManager::Collide()
 {
+	// Filtering and broad-phase checks can destroy contacts, so they stay
+	// serial. With a thread pool the persisting contacts are only queued.
+	bool parallel = m_threadPool != NULL;
+	int32 updateCount = 0;
+	if (parallel && m_updateCapacity < m_contactCount)
+	{
+		b2Free(m_updateBuffer);
+		m_updateCapacity = b2Max(m_contactCount, 2 * m_updateCapacity);
+		m_updateBuffer = (b2ContactUpdate*)b2Alloc(m_updateCapacity * sizeof(b2ContactUpdate));
+	}
+
 	// Update awake contacts.
 	b2Contact* c = m_contactList;
 	while (c)
@@ -164,9 +184,39 @@ void b2ContactManager::Collide()
 		}
 
 		// The contact persists.
-		c->Update(m_contactListener);
+		if (parallel)
+		{
+			m_updateBuffer[updateCount++].contact = c;
+		}
+		else
+		{
+			c->Update(m_contactListener);
+		}
 		c = c->GetNext();
 	}
+
+	if (parallel)
+	{
+		const int32 contactsPerTask = 64;
+		m_threadPool->ParallelFor(updateCount, contactsPerTask, UpdateManifolds, m_updateBuffer);
+
+		// Wake bodies and report in list order, whatever the scheduling.
+		for (int32 i = 0; i < updateCount; ++i)
+		{
+			b2ContactUpdate& update = m_updateBuffer[i];
+			update.contact->ReportUpdate(update.wasTouching, &update.oldManifold, m_contactListener);
+		}
+	}
+}
+
+void b2ContactManager::UpdateManifolds(void* context, int32 begin, int32 end, int32 threadIndex)
+{
+	B2_NOT_USED(threadIndex);
+	b2ContactUpdate* updates = (b2ContactUpdate*)context;
+	for (int32 i = begin; i < end; ++i)
+	{
+		updates[i].wasTouching = updates[i].contact->UpdateManifold(&updates[i].oldManifold);
+	}
 }
 
 void b2ContactManager::FindNewContacts()
@@ -25,12 +25,22 @@ class b2Contact;
 class b2ContactFilter;
 class b2ContactListener;
 class b2BlockAllocator;
+class b2ThreadPool;
+
+// A persisting contact queued for the parallel narrowphase.
+struct b2ContactUpdate
+{
+	b2Contact* contact;
+	b2Manifold oldManifold;
+	bool wasTouching;
+};
 
 // Delegate of b2World.
 class b2ContactManager
 {
 public:
 	b2ContactManager();
+	~b2ContactManager();
 
 	// Broad-phase callback.
 	void AddPair(void* proxyUserDataA, void* proxyUserDataB);
@@ -39,7 +49,11 @@ public:
 
 	void Destroy(b2Contact* c);
 
+	// With a thread pool, manifolds are evaluated on its workers and the
+	// listener is called afterwards, in contact list order.
 	void Collide();
+
+	static void UpdateManifolds(void* context, int32 begin, int32 end, int32 threadIndex);
             
 	b2BroadPhase m_broadPhase;
 	b2Contact* m_contactList;
@@ -47,6 +61,10 @@ public:
 	b2ContactFilter* m_contactFilter;
 	b2ContactListener* m_contactListener;
 	b2BlockAllocator* m_allocator;
+
+	b2ThreadPool* m_threadPool;
+	b2ContactUpdate* m_updateBuffer;
+	int32 m_updateCapacity;
 };
 
 #endif
@@ -45,6 +45,15 @@ struct b2TimeStep
 	bool warmStarting;
 };
 
+/// Speeds below which a body counts as resting, and how long it must rest
+/// before it may sleep. Defaults come from b2Settings.h.
+struct b2SleepTolerance
+{
+	float32 linear;			// linear speed
+	float32 angular;		// angular speed
+	float32 timeToSleep;	// seconds at rest before sleeping
+};
+
 /// This is an internal structure.
 struct b2Position
 {
@@ -31,9 +31,13 @@
 #include <Box2D/Collision/Shapes/b2PolygonShape.h>
 #include <Box2D/Collision/b2TimeOfImpact.h>
 #include <Box2D/Common/b2Draw.h>
+#include <Box2D/Common/b2ThreadPool.h>
 #include <Box2D/Common/b2Timer.h>
+#include <algorithm>
 #include <new>
 
+extern b2ContactListener b2_defaultListener;
+
 b2World::b2World(const b2Vec2& gravity)
 {
 	m_destructionListener = NULL;
@@ -52,8 +56,15 @@ b2World::b2World(const b2Vec2& gravity)
 	m_stepComplete = true;
 
 	m_allowSleep = true;
+	m_sleepTolerance.linear = b2_linearSleepTolerance;
+	m_sleepTolerance.angular = b2_angularSleepTolerance;
+	m_sleepTolerance.timeToSleep = b2_timeToSleep;
 	m_gravity = gravity;
 
+	m_threadPool = NULL;
+	m_threadAllocators = NULL;
+	m_threadAllocatorCount = 0;
+
 	m_flags = e_clearForces;
 
 	m_inv_dt0 = 0.0f;
@@ -82,6 +93,8 @@ b2World::~b2World()
 
 		b = bNext;
 	}
+
+	SetThreadPool(NULL);
 }
 
 void b2World::SetDestructionListener(b2DestructionListener* listener)
@@ -382,6 +395,213 @@ void b2World::SetAllowSleeping(bool flag)
 	}
 }
 
+void b2World::SetSleepTolerance(float32 linear, float32 angular, float32 timeToSleep)
+{
+	m_sleepTolerance.linear = linear;
+	m_sleepTolerance.angular = angular;
+	m_sleepTolerance.timeToSleep = timeToSleep;
+}
+
+void b2World::SetThreadPool(b2ThreadPool* pool)
+{
+	b2Assert(IsLocked() == false);
+
+	for (int32 i = 0; i < m_threadAllocatorCount; ++i)
+	{
+		m_threadAllocators[i].~b2StackAllocator();
+	}
+	b2Free(m_threadAllocators);
+	m_threadAllocators = NULL;
+	m_threadAllocatorCount = 0;
+
+	m_threadPool = pool;
+	m_contactManager.m_threadPool = pool;
+	if (pool != NULL && pool->GetThreadCount() > 1)
+	{
+		m_threadAllocatorCount = pool->GetThreadCount() - 1;
+		m_threadAllocators = (b2StackAllocator*)b2Alloc(m_threadAllocatorCount * sizeof(b2StackAllocator));
+		for (int32 i = 0; i < m_threadAllocatorCount; ++i)
+		{
+			new (m_threadAllocators + i) b2StackAllocator;
+		}
+	}
+}
+
+// An island recorded for the thread pool, as ranges of the batch arrays.
+struct b2IslandRange
+{
+	int32 bodyStart;
+	int32 bodyCount;
+	int32 contactStart;
+	int32 contactCount;
+	int32 jointStart;
+	int32 jointCount;
+};
+
+// A static body and one of the islands it is in.
+struct b2StaticUse
+{
+	b2Body* body;
+	int32 island;
+};
+
+inline bool b2StaticUseLessThan(const b2StaticUse& a, const b2StaticUse& b)
+{
+	if (a.body != b.body)
+	{
+		return a.body < b.body;
+	}
+	return a.island < b.island;
+}
+
+// The islands of one step and how they are split into work items.
+struct b2IslandBatch
+{
+	b2Body** bodies;
+	b2Contact** contacts;
+	b2Joint** joints;
+	b2IslandRange* islands;
+	b2StaticUse* statics;
+	int32 bodyCount;
+	int32 contactCount;
+	int32 jointCount;
+	int32 islandCount;
+	int32 staticCount;
+
+	// Item i solves islands order[itemStart[i]] to order[itemStart[i + 1] - 1].
+	int32* order;
+	int32* itemStart;
+	int32 itemCount;
+	b2Profile* profiles;
+
+	const b2TimeStep* step;
+	b2Vec2 gravity;
+	bool allowSleep;
+	b2SleepTolerance sleep;
+	b2ContactListener* listener;
+	b2StackAllocator* allocator;
+	b2StackAllocator* threadAllocators;
+};
+
+static int32 b2FindIslandRoot(int32* parent, int32 i)
+{
+	while (parent[i] != i)
+	{
+		parent[i] = parent[parent[i]];
+		i = parent[i];
+	}
+	return i;
+}
+
+// Islands sharing a static body both write to it, so they go in the same
+// work item and are solved in order. Items are numbered by their first
+// island, so the split only depends on the island order.
+static void b2GroupIslands(b2IslandBatch* batch, b2StackAllocator* allocator)
+{
+	int32 n = batch->islandCount;
+	int32* parent = (int32*)allocator->Allocate(n * sizeof(int32));
+	int32* itemOf = (int32*)allocator->Allocate(n * sizeof(int32));
+	for (int32 i = 0; i < n; ++i)
+	{
+		parent[i] = i;
+		itemOf[i] = -1;
+	}
+
+	std::sort(batch->statics, batch->statics + batch->staticCount, b2StaticUseLessThan);
+	for (int32 i = 1; i < batch->staticCount; ++i)
+	{
+		if (batch->statics[i].body != batch->statics[i - 1].body)
+		{
+			continue;
+		}
+
+		int32 rootA = b2FindIslandRoot(parent, batch->statics[i - 1].island);
+		int32 rootB = b2FindIslandRoot(parent, batch->statics[i].island);
+		parent[b2Max(rootA, rootB)] = b2Min(rootA, rootB);
+	}
+
+	// The root is the lowest island of its group, so it is seen first.
+	int32* itemStart = batch->itemStart;
+	int32 itemCount = 0;
+	for (int32 i = 0; i < n; ++i)
+	{
+		int32 root = b2FindIslandRoot(parent, i);
+		if (itemOf[root] == -1)
+		{
+			itemOf[root] = itemCount;
+			itemStart[++itemCount] = 0;
+		}
+		parent[i] = root;
+		++itemStart[itemOf[root] + 1];
+	}
+
+	itemStart[0] = 0;
+	for (int32 i = 0; i < itemCount; ++i)
+	{
+		itemStart[i + 1] += itemStart[i];
+	}
+
+	// Counting sort by item, keeping island order within each.
+	int32* cursor = parent;
+	for (int32 i = 0; i < n; ++i)
+	{
+		cursor[i] = itemOf[parent[i]];
+	}
+	for (int32 i = 0; i < n; ++i)
+	{
+		int32 item = cursor[i];
+		batch->order[itemStart[item]++] = i;
+	}
+	for (int32 i = itemCount; i > 0; --i)
+	{
+		itemStart[i] = itemStart[i - 1];
+	}
+	itemStart[0] = 0;
+
+	batch->itemCount = itemCount;
+
+	allocator->Free(itemOf);
+	allocator->Free(parent);
+}
+
+static void b2SolveIslandItems(void* context, int32 begin, int32 end, int32 threadIndex)
+{
+	b2IslandBatch* batch = (b2IslandBatch*)context;
+	b2StackAllocator* allocator = threadIndex == 0 ? batch->allocator : batch->threadAllocators + (threadIndex - 1);
+
+	for (int32 item = begin; item < end; ++item)
+	{
+		b2Profile& total = batch->profiles[item];
+		total.solveInit = 0.0f;
+		total.solveVelocity = 0.0f;
+		total.solvePosition = 0.0f;
+
+		for (int32 k = batch->itemStart[item]; k < batch->itemStart[item + 1]; ++k)
+		{
+			const b2IslandRange& range = batch->islands[batch->order[k]];
+			b2Island island(range.bodyCount, range.contactCount, range.jointCount, allocator, batch->listener);
+			for (int32 i = 0; i < range.bodyCount; ++i)
+			{
+				island.Add(batch->bodies[range.bodyStart + i]);
+			}
+			for (int32 i = 0; i < range.contactCount; ++i)
+			{
+				island.Add(batch->contacts[range.contactStart + i]);
+			}
+			for (int32 i = 0; i < range.jointCount; ++i)
+			{
+				island.Add(batch->joints[range.jointStart + i]);
+			}
+
+			b2Profile profile;
+			island.Solve(&profile, *batch->step, batch->gravity, batch->allowSleep, batch->sleep);
+			total.solveInit += profile.solveInit;
+			total.solveVelocity += profile.solveVelocity;
+			total.solvePosition += profile.solvePosition;
+		}
+	}
+}
+
 // Find islands, integrate and solve constraints, solve position constraints
 void b2World::Solve(const b2TimeStep& step)
 {
@@ -410,6 +630,29 @@ void b2World::Solve(const b2TimeStep& step)
 		j->m_islandFlag = false;
 	}
 
+	// With a thread pool the islands are only recorded here and solved on
+	// its workers afterwards. A contact listener keeps them serial, so
+	// PostSolve is never called from a worker.
+	bool parallel = m_threadPool != NULL && m_threadAllocatorCount > 0 &&
+					m_contactManager.m_contactListener == &b2_defaultListener;
+	b2IslandBatch batch;
+	if (parallel)
+	{
+		// Static bodies can repeat across islands, once per contact or joint at most.
+		int32 contactCapacity = m_contactManager.m_contactCount;
+		int32 staticCapacity = contactCapacity + m_jointCount;
+		batch.bodies = (b2Body**)m_stackAllocator.Allocate((m_bodyCount + staticCapacity) * sizeof(b2Body*));
+		batch.contacts = (b2Contact**)m_stackAllocator.Allocate(contactCapacity * sizeof(b2Contact*));
+		batch.joints = (b2Joint**)m_stackAllocator.Allocate(m_jointCount * sizeof(b2Joint*));
+		batch.islands = (b2IslandRange*)m_stackAllocator.Allocate(m_bodyCount * sizeof(b2IslandRange));
+		batch.statics = (b2StaticUse*)m_stackAllocator.Allocate(staticCapacity * sizeof(b2StaticUse));
+		batch.bodyCount = 0;
+		batch.contactCount = 0;
+		batch.jointCount = 0;
+		batch.islandCount = 0;
+		batch.staticCount = 0;
+	}
+
 	// Build and simulate all awake islands.
 	int32 stackSize = m_bodyCount;
 	b2Body** stack = (b2Body**)m_stackAllocator.Allocate(stackSize * sizeof(b2Body*));
@@ -527,11 +770,30 @@ void b2World::Solve(const b2TimeStep& step)
 			}
 		}
 
-		b2Profile profile;
-		island.Solve(&profile, step, m_gravity, m_allowSleep);
-		m_profile.solveInit += profile.solveInit;
-		m_profile.solveVelocity += profile.solveVelocity;
-		m_profile.solvePosition += profile.solvePosition;
+		if (parallel)
+		{
+			b2IslandRange& range = batch.islands[batch.islandCount];
+			range.bodyStart = batch.bodyCount;
+			range.bodyCount = island.m_bodyCount;
+			range.contactStart = batch.contactCount;
+			range.contactCount = island.m_contactCount;
+			range.jointStart = batch.jointCount;
+			range.jointCount = island.m_jointCount;
+			memcpy(batch.bodies + batch.bodyCount, island.m_bodies, island.m_bodyCount * sizeof(b2Body*));
+			memcpy(batch.contacts + batch.contactCount, island.m_contacts, island.m_contactCount * sizeof(b2Contact*));
+			memcpy(batch.joints + batch.jointCount, island.m_joints, island.m_jointCount * sizeof(b2Joint*));
+			batch.bodyCount += island.m_bodyCount;
+			batch.contactCount += island.m_contactCount;
+			batch.jointCount += island.m_jointCount;
+		}
+		else
+		{
+			b2Profile profile;
+			island.Solve(&profile, step, m_gravity, m_allowSleep, m_sleepTolerance);
+			m_profile.solveInit += profile.solveInit;
+			m_profile.solveVelocity += profile.solveVelocity;
+			m_profile.solvePosition += profile.solvePosition;
+		}
 
 		// Post solve cleanup.
 		for (int32 i = 0; i < island.m_bodyCount; ++i)
@@ -541,12 +803,62 @@ void b2World::Solve(const b2TimeStep& step)
 			if (b->GetType() == b2_staticBody)
 			{
 				b->m_flags &= ~b2Body::e_islandFlag;
+
+				if (parallel)
+				{
+					b2StaticUse& use = batch.statics[batch.staticCount++];
+					use.body = b;
+					use.island = batch.islandCount;
+				}
 			}
 		}
+
+		if (parallel)
+		{
+			++batch.islandCount;
+		}
 	}
 
 	m_stackAllocator.Free(stack);
 
+	if (parallel)
+	{
+		int32 islandCount = batch.islandCount;
+		batch.order = (int32*)m_stackAllocator.Allocate(islandCount * sizeof(int32));
+		batch.itemStart = (int32*)m_stackAllocator.Allocate((islandCount + 1) * sizeof(int32));
+		b2GroupIslands(&batch, &m_stackAllocator);
+		batch.profiles = (b2Profile*)m_stackAllocator.Allocate(batch.itemCount * sizeof(b2Profile));
+
+		batch.step = &step;
+		batch.gravity = m_gravity;
+		batch.allowSleep = m_allowSleep;
+		batch.sleep = m_sleepTolerance;
+		batch.listener = m_contactManager.m_contactListener;
+		batch.allocator = &m_stackAllocator;
+		batch.threadAllocators = m_threadAllocators;
+
+		// Most islands are a body or two, so hand them out in batches.
+		const int32 itemsPerTask = 16;
+		m_threadPool->ParallelFor(batch.itemCount, itemsPerTask, b2SolveIslandItems, &batch);
+
+		// Sum in item order so the profile does not depend on scheduling.
+		for (int32 i = 0; i < batch.itemCount; ++i)
+		{
+			m_profile.solveInit += batch.profiles[i].solveInit;
+			m_profile.solveVelocity += batch.profiles[i].solveVelocity;
+			m_profile.solvePosition += batch.profiles[i].solvePosition;
+		}
+
+		m_stackAllocator.Free(batch.profiles);
+		m_stackAllocator.Free(batch.itemStart);
+		m_stackAllocator.Free(batch.order);
+		m_stackAllocator.Free(batch.statics);
+		m_stackAllocator.Free(batch.islands);
+		m_stackAllocator.Free(batch.joints);
+		m_stackAllocator.Free(batch.contacts);
+		m_stackAllocator.Free(batch.bodies);
+	}
+
 	{
 		b2Timer timer;
 		// Synchronize fixtures, check for out of range bodies.
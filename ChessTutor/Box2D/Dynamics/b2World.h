@@ -34,6 +34,7 @@ class b2Body;
 class b2Draw;
 class b2Fixture;
 class b2Joint;
+class b2ThreadPool;
 
 /// The world class manages all physics entities, dynamic simulation,
 /// and asynchronous queries. The world also contains efficient memory
@@ -145,6 +146,21 @@ public:
 	void SetAllowSleeping(bool flag);
 	bool GetAllowSleeping() const { return m_allowSleep; }
 
+	/// Set how slow a body must be, and for how long, before it may sleep.
+	void SetSleepTolerance(float32 linear, float32 angular, float32 timeToSleep);
+	const b2SleepTolerance& GetSleepTolerance() const { return m_sleepTolerance; }
+
+	/// Evaluate contacts and solve islands on the workers of a thread pool,
+	/// or serially if NULL. The pool is not owned and must outlive its use
+	/// here. Contact listener callbacks always run on the stepping thread:
+	/// begin, end and pre-solve are reported in contact list order once all
+	/// manifolds are evaluated, and islands are solved serially while a
+	/// listener is set, so PostSolve is never called from a worker.
+	/// With a pool, a contact whose bodies were both asleep when the step
+	/// began waits for the next step, even if another contact wakes them.
+	void SetThreadPool(b2ThreadPool* pool);
+	b2ThreadPool* GetThreadPool() const { return m_threadPool; }
+
 	/// Enable/disable warm starting. For testing.
 	void SetWarmStarting(bool flag) { m_warmStarting = flag; }
 	bool GetWarmStarting() const { return m_warmStarting; }
@@ -245,6 +261,13 @@ private:
 
 	b2Vec2 m_gravity;
 	bool m_allowSleep;
+	b2SleepTolerance m_sleepTolerance;
+
+	// Workers for island solving, each with its own stack allocator.
+	// Thread 0 is the stepping thread and uses m_stackAllocator.
+	b2ThreadPool* m_threadPool;
+	b2StackAllocator* m_threadAllocators;
+	int32 m_threadAllocatorCount;
 
 	b2DestructionListener* m_destructionListener;
 	b2Draw* m_debugDraw;
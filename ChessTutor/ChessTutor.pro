@@ -1,7 +1,8 @@
 QT       += core gui
-QT += multimedia
+QT += multimedia svg
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+greaterThan(QT_MAJOR_VERSION, 5): QT += opengl openglwidgets
 
 CONFIG += c++17
 
@@ -27,6 +28,7 @@ SOURCES += \
     Box2D/Common/b2Math.cpp \
     Box2D/Common/b2Settings.cpp \
     Box2D/Common/b2StackAllocator.cpp \
+    Box2D/Common/b2ThreadPool.cpp \
     Box2D/Common/b2Timer.cpp \
     Box2D/Dynamics/Contacts/b2ChainAndCircleContact.cpp \
     Box2D/Dynamics/Contacts/b2ChainAndPolygonContact.cpp \
@@ -56,12 +58,26 @@ SOURCES += \
     Box2D/Dynamics/b2World.cpp \
     Box2D/Dynamics/b2WorldCallbacks.cpp \
     Box2D/Rope/b2Rope.cpp \
+    assetmanager.cpp \
     chess.cpp \
     chessboard.cpp \
     chesspuzzle.cpp \
     confetticontroller.cpp \
+    effectlibrary.cpp \
+    evaluation.cpp \
+    frameclock.cpp \
+    glboardview.cpp \
     main.cpp \
-    mainwindow.cpp
+    mainwindow.cpp \
+    openingbook.cpp \
+    particleemitter.cpp \
+    particlekernel.cpp \
+    particlesystem.cpp \
+    pawnhash.cpp \
+    pieceset.cpp \
+    qualitygovernor.cpp \
+    soundmanager.cpp \
+    tablebase.cpp
 
 HEADERS += \
     Box2D/Box2D.h \
@@ -81,6 +97,7 @@ HEADERS += \
     Box2D/Common/b2Math.h \
     Box2D/Common/b2Settings.h \
     Box2D/Common/b2StackAllocator.h \
+    Box2D/Common/b2ThreadPool.h \
     Box2D/Common/b2Timer.h \
     Box2D/Dynamics/Contacts/b2ChainAndCircleContact.h \
     Box2D/Dynamics/Contacts/b2ChainAndPolygonContact.h \
@@ -111,11 +128,25 @@ HEADERS += \
     Box2D/Dynamics/b2World.h \
     Box2D/Dynamics/b2WorldCallbacks.h \
     Box2D/Rope/b2Rope.h \
+    assetmanager.h \
     chess.h \
     chessboard.h \
     chesspuzzle.h \
     confetticontroller.h \
-    mainwindow.h
+    effectlibrary.h \
+    evaluation.h \
+    frameclock.h \
+    glboardview.h \
+    mainwindow.h \
+    openingbook.h \
+    particleemitter.h \
+    particlekernel.h \
+    particlesystem.h \
+    pawnhash.h \
+    pieceset.h \
+    qualitygovernor.h \
+    soundmanager.h \
+    tablebase.h
 
 FORMS += \
     mainwindow.ui
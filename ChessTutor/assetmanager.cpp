@@ -0,0 +1,137 @@
+#include "assetmanager.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QPointer>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+// Raw cache file header: magic, version, width, height, format, bytes per line
+static const quint32 kCacheMagic = 0x4354494D;  // "CTIM"
+static const quint32 kCacheVersion = 1;
+
+AssetManager::AssetManager(QObject* parent)
+    : QObject(parent)
+{
+    QString base = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (!base.isEmpty())
+        setCacheDirectory(QDir(base).filePath("assets"));
+}
+
+AssetManager::~AssetManager() {
+    pool.waitForDone();
+}
+
+AssetManager& AssetManager::shared() {
+    static AssetManager manager;
+    return manager;
+}
+
+void AssetManager::setCacheDirectory(const QString& directory) {
+    cacheDir = directory;
+    if (!cacheDir.isEmpty())
+        QDir().mkpath(cacheDir);
+}
+
+void AssetManager::load(const QString& path, QObject* context, Ready ready, QSize scaledTo) {
+    ++requests;
+    QPointer<QObject> target(context);
+    pool.start([this, path, scaledTo, target, ready]() {
+        QImage image = decode(path, scaledTo);
+        if (!target) return;
+        QMetaObject::invokeMethod(target, [target, ready, image]() {
+            if (target) ready(image);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void AssetManager::waitForAll() {
+    pool.waitForDone();
+}
+
+AssetStats AssetManager::stats() const {
+    AssetStats s;
+    s.requests = requests;
+    s.diskHits = diskHits;
+    s.decodes = decodes;
+    s.failures = failures;
+    return s;
+}
+
+QImage AssetManager::decode(const QString& path, QSize scaledTo) {
+    // Resources are compressed PNGs already mapped with the executable;
+    // reading them is cheaper than a raw-pixel cache entry, so only files
+    // on disk are cached. Key on path, size and mtime so a hit costs one
+    // stat and never touches the source bytes.
+    QString cacheFile;
+    bool resource = path.startsWith(QLatin1Char(':')) || path.startsWith(QLatin1String("qrc:"));
+    if (!cacheDir.isEmpty() && !resource) {
+        QFileInfo info(path);
+        if (info.isFile()) {
+            QByteArray key = info.absoluteFilePath().toUtf8() + '\n'
+                + QByteArray::number(info.size()) + '\n'
+                + QByteArray::number(info.lastModified().toMSecsSinceEpoch()) + '\n'
+                + QByteArray::number(scaledTo.width()) + 'x' + QByteArray::number(scaledTo.height());
+            QByteArray name = QCryptographicHash::hash(key, QCryptographicHash::Sha1).toHex();
+            cacheFile = QDir(cacheDir).filePath(QString::fromLatin1(name) + ".img");
+
+            QImage cached = readCache(cacheFile);
+            if (!cached.isNull()) {
+                ++diskHits;
+                return cached;
+            }
+        }
+    }
+
+    QImage image(path);
+    if (image.isNull()) {
+        ++failures;
+        return image;
+    }
+    ++decodes;
+
+    image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    if (scaledTo.isValid())
+        image = image.scaled(scaledTo, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+
+    if (!cacheFile.isEmpty())
+        writeCache(cacheFile, image);
+    return image;
+}
+
+QImage AssetManager::readCache(const QString& file) {
+    QFile in(file);
+    if (!in.open(QIODevice::ReadOnly)) return QImage();
+
+    QDataStream stream(&in);
+    quint32 magic, version, width, height, format, stride;
+    stream >> magic >> version >> width >> height >> format >> stride;
+    if (stream.status() != QDataStream::Ok || magic != kCacheMagic || version != kCacheVersion
+        || format != QImage::Format_ARGB32_Premultiplied || width == 0 || height == 0
+        || width > 16384 || height > 16384 || stride < width * 4)
+        return QImage();
+
+    QImage image(int(width), int(height), QImage::Format_ARGB32_Premultiplied);
+    if (image.isNull() || quint32(image.bytesPerLine()) != stride) return QImage();
+
+    qint64 bytes = qint64(stride) * height;
+    if (in.read(reinterpret_cast<char*>(image.bits()), bytes) != bytes) return QImage();
+    return image;
+}
+
+void AssetManager::writeCache(const QString& file, const QImage& image) {
+    // QSaveFile renames into place on commit, so a crash never leaves a torn file
+    QSaveFile out(file);
+    if (!out.open(QIODevice::WriteOnly)) return;
+
+    QDataStream stream(&out);
+    stream << kCacheMagic << kCacheVersion
+           << quint32(image.width()) << quint32(image.height())
+           << quint32(image.format()) << quint32(image.bytesPerLine());
+    out.write(reinterpret_cast<const char*>(image.constBits()),
+              qint64(image.bytesPerLine()) * image.height());
+    out.commit();
+}
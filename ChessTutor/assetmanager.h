@@ -0,0 +1,132 @@
+/*
+ * assetmanager.h
+ *
+ * Defines the AssetManager class, which decodes images on a thread pool
+ * so the window can show immediately with placeholders. Images loaded from
+ * files on disk are cached decoded (and optionally pre-scaled) as raw
+ * pixels keyed by path, size and modification time; resources embedded
+ * through Asset.qrc are always decoded, which beats reading raw pixels.
+ *
+ * @author  ESL Team
+ * @date    2026-10-16
+ */
+#ifndef ASSETMANAGER_H
+#define ASSETMANAGER_H
+
+#include <QObject>
+#include <QImage>
+#include <QSize>
+#include <QString>
+#include <QThreadPool>
+#include <atomic>
+#include <functional>
+
+/**
+ * AssetStats
+ *
+ * Counters describing how requests were served.
+ */
+struct AssetStats {
+    int requests{0};   ///< load() calls
+    int diskHits{0};   ///< Served from the on-disk cache (files only)
+    int decodes{0};    ///< Decoded from the source file
+    int failures{0};   ///< Source missing or undecodable
+};
+
+/**
+ * AssetManager
+ *
+ * Asynchronous image loader with a disk cache for file-system images.
+ * Results are delivered on the thread that owns the context object
+ * (normally the GUI thread).
+ */
+class AssetManager : public QObject {
+    Q_OBJECT
+
+public:
+    /// Callback receiving the decoded image (null if loading failed)
+    using Ready = std::function<void(const QImage&)>;
+
+    /**
+     * Constructor
+     *
+     * @param parent Optional parent QObject.
+     */
+    explicit AssetManager(QObject* parent = nullptr);
+
+    /**
+     * Destructor
+     *
+     * Waits for in-flight decodes.
+     */
+    ~AssetManager() override;
+
+    /**
+     * shared
+     *
+     * @return Manager used by the board and main window.
+     */
+    static AssetManager& shared();
+
+    /**
+     * setCacheDirectory
+     *
+     * Folder for cached decodes; an empty string disables the disk cache.
+     * Defaults to an "assets" folder under the platform cache location.
+     */
+    void setCacheDirectory(const QString& directory);
+
+    /**
+     * load
+     *
+     * Decode an image in the background.
+     *
+     * @param path     File or resource path.
+     * @param context  Receives the callback; dropped if destroyed first.
+     * @param ready    Called with the image on the context's thread.
+     * @param scaledTo Optional size to pre-scale to (aspect ratio kept).
+     */
+    void load(const QString& path, QObject* context, Ready ready, QSize scaledTo = QSize());
+
+    /**
+     * waitForAll
+     *
+     * Block until every queued decode has finished. Callbacks still arrive
+     * through the event loop.
+     */
+    void waitForAll();
+
+    /**
+     * stats
+     *
+     * @return Counters since construction.
+     */
+    AssetStats stats() const;
+
+private:
+    /**
+     * decode
+     *
+     * Worker-thread body: for files, serve from the disk cache if an entry
+     * matches the file's path, size and mtime; otherwise decode, scale, and
+     * (for files) write the cache entry.
+     */
+    QImage decode(const QString& path, QSize scaledTo);
+
+    /**
+     * readCache / writeCache
+     *
+     * Raw-pixel cache files: a small header followed by the scanlines.
+     */
+    static QImage readCache(const QString& file);
+    static void writeCache(const QString& file, const QImage& image);
+
+    QThreadPool      pool;        ///< Decode workers
+    QString          cacheDir;    ///< Disk cache folder, empty when disabled
+    std::atomic<int> requests{0};
+    std::atomic<int> diskHits{0};
+    std::atomic<int> decodes{0};
+    std::atomic<int> failures{0};
+};
+
+#endif // ASSETMANAGER_H
@@ -1,9 +1,10 @@
 #include "chess.h"
 #include "confetticontroller.h"
+#include "tablebase.h"
+#include "openingbook.h"
 #include <cctype>
 #include <iostream>
 #include <cstdlib>
-#include <QSoundEffect>
 using std::cout;
 using std::endl;
 using std::tolower;
@@ -65,16 +66,17 @@ void Chess::switchPlayer(){
 }
 
 void Chess::clearBoard(){
-    for(int row = 0; row < 8; row--){
-        for(int col = 0; col < 8; col--){
+    for(int row = 0; row < 8; row++){
+        for(int col = 0; col < 8; col++){
             board[row][col] = 0;
         }
     }
+    resetEvaluation();
     if(debugging) printBoard();
 }
 
 void Chess::addPiece(const Player player, const Piece piece, const Square square){
-    board[square.row][square.col] = player * piece;
+    setSquare(square.row, square.col, player * piece);
 }
 
 int Chess::getPiece(const Square position){
@@ -287,22 +289,15 @@ void Chess::movePieceUnconditionally(const Square old, const Square target){
         if (debugging) cout << "Tango Down, load the 'fetti' launcher" << endl;
     }
 
-    board[target.row][target.col] = board[old.row][old.col];
-    board[old.row][old.col] = 0;
+    setSquare(target.row, target.col, board[old.row][old.col]);
+    setSquare(old.row, old.col, 0);
     if(debugging) printBoard();
     switchPlayer();
 
-    // play sound effect
-    QSoundEffect *effect = new QSoundEffect;
-    effect->setSource(QUrl("qrc:/Assets/Assets/ChessMove.wav"));
-    effect->setVolume(1);
-    effect->play();
+    emit piece_moved();
 
     if (isKingTaken){
         emit won_game();
-        effect->setSource(QUrl("qrc:/Assets/Assets/Confetti.wav"));
-        effect->setVolume(1);
-        effect->play();
     }
     emit update_board();
 }
@@ -323,6 +318,7 @@ void Chess::loadDefaultBoard(){
             board[row][col] = defaultBoard[row][col];
         }
     }
+    resetEvaluation();
     if(debugging) printBoard();
 }
 
@@ -333,6 +329,7 @@ void Chess::loadBoard(int newBoard[8][8]){
             board[row][col] = newBoard[row][col];
         }
     }
+    resetEvaluation();
 }
 
 void Chess::printBoard(){
@@ -364,3 +361,67 @@ std::vector<std::vector<int>> Chess::getBoardVector() const {
             v[i][j] = board[i][j];
     return v;
 }
+
+void Chess::setSquare(int row, int col, int piece){
+    accumulator.remove(board[row][col], row, col);
+    pawnKey ^= pawnZobrist(board[row][col], row, col);
+    board[row][col] = piece;
+    accumulator.add(piece, row, col);
+    pawnKey ^= pawnZobrist(piece, row, col);
+}
+
+void Chess::resetEvaluation(){
+    accumulator.reset();
+    pawnKey = 0;
+    for(int row = 0; row < 8; row++){
+        for(int col = 0; col < 8; col++){
+            accumulator.add(board[row][col], row, col);
+            pawnKey ^= pawnZobrist(board[row][col], row, col);
+        }
+    }
+}
+
+MoveUndo Chess::makeMove(const Square old, const Square target){
+    MoveUndo undo{old, target, board[old.row][old.col], board[target.row][target.col]};
+    setSquare(target.row, target.col, undo.moved);
+    setSquare(old.row, old.col, 0);
+    currentPlayer = currentPlayer == WHITE ? BLACK : WHITE;
+    return undo;
+}
+
+void Chess::unmakeMove(const MoveUndo& undo){
+    setSquare(undo.from.row, undo.from.col, undo.moved);
+    setSquare(undo.to.row, undo.to.col, undo.captured);
+    currentPlayer = currentPlayer == WHITE ? BLACK : WHITE;
+}
+
+EvalBreakdown Chess::evaluate() const {
+    EvalBreakdown result;
+    result.phase = accumulator.phase > kMaxPhase ? kMaxPhase : accumulator.phase;
+    result.material = taper(accumulator.material, result.phase);
+    result.pieceSquare = taper(accumulator.pieceSquare, result.phase);
+    result.pawnStructure = taper(pawnTable->probe(pawnKey, board).score, result.phase);
+    result.mobility = taper(evaluateMobility(board), result.phase);
+    result.total = result.material + result.pieceSquare + result.pawnStructure + result.mobility;
+
+    // A tablebase result is exact; keep material as a tiebreak so search
+    // still prefers converting lines.
+    int wdl;
+    if (tablebase && tablebase->covers(board) && tablebase->probeWdl(board, currentPlayer, wdl)){
+        int value = wdl == Tablebase::Win ? kTablebaseWin : wdl == Tablebase::Loss ? -kTablebaseWin : 0;
+        result.tablebase = value * currentPlayer;
+        result.fromTablebase = true;
+        result.total = result.tablebase + result.material;
+    }
+    return result;
+}
+
+bool Chess::tablebaseHint(TablebaseMove& move){
+    if (!tablebase || !tablebase->covers(board)) return false;
+    return tablebase->bestMove(board, currentPlayer, move);
+}
+
+bool Chess::bookHint(BookMove& move) const {
+    if (!openingBook || !openingBook->isOpen()) return false;
+    return openingBook->pickMove(board, currentPlayer, move);
+}
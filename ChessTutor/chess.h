@@ -14,6 +14,13 @@
 #include <string>
 #include <vector>
 #include <QObject>
+#include "evaluation.h"
+#include "pawnhash.h"
+
+class Tablebase;
+struct TablebaseMove;
+class OpeningBook;
+struct BookMove;
 
 /**
  * Square
@@ -76,6 +83,18 @@ enum Player{
     BLACK = -1 ///< Black (negative piece codes)
 };
 
+/**
+ * MoveUndo
+ *
+ * Everything needed to take back a move made with Chess::makeMove.
+ */
+struct MoveUndo{
+    Square from;   ///< Square the piece moved from
+    Square to;     ///< Square the piece moved to
+    int moved;     ///< Piece code that moved
+    int captured;  ///< Piece code that was on the destination (0 if none)
+};
+
 /**
  * Chess
  *
@@ -168,11 +187,114 @@ public:
      */
     std::vector<std::vector<int>> getBoardVector() const;
 
+    /**
+     * makeMove
+     *
+     * Silently applies a move for search: no signals, sound or legality
+     * checks. Material and piece-square scores are updated incrementally.
+     * @param oldSquare Starting square
+     * @param newSquare Destination square
+     * @return Record to pass to unmakeMove
+     */
+    MoveUndo makeMove(const Square oldSquare, const Square newSquare);
+
+    /**
+     * unmakeMove
+     *
+     * Takes back a move made with makeMove, restoring the board, side to
+     * move and evaluation state.
+     * @param undo Record returned by makeMove
+     */
+    void unmakeMove(const MoveUndo& undo);
+
+    /**
+     * evaluate
+     *
+     * Tapered static evaluation of the current position, with a per-term
+     * breakdown. Scores are in centipawns from White's point of view.
+     * @return Breakdown of material, placement, pawn structure and mobility
+     */
+    EvalBreakdown evaluate() const;
+
+    /**
+     * setPawnHashTable
+     *
+     * Use a dedicated pawn hash table instead of PawnHashTable::shared().
+     * @param table Table to probe; must outlive this object
+     */
+    void setPawnHashTable(PawnHashTable* table) { pawnTable = table; }
+
+    /**
+     * setTablebase
+     *
+     * Let evaluate() and tablebaseHint() consult endgame tablebases.
+     * @param tb Prober to use, or nullptr to disable; must outlive this object
+     */
+    void setTablebase(Tablebase* tb) { tablebase = tb; }
+
+    /**
+     * tablebaseHint
+     *
+     * Best move for the side to move according to the tablebase.
+     * @param move Receives the move and its outcome
+     * @return False if no tablebase is set or the position is not covered.
+     */
+    bool tablebaseHint(TablebaseMove& move);
+
+    /**
+     * setOpeningBook
+     *
+     * Let bookHint() consult an opening book.
+     * @param book Book to use, or nullptr to disable; must outlive this object
+     */
+    void setOpeningBook(const OpeningBook* book) { openingBook = book; }
+
+    /**
+     * bookHint
+     *
+     * Book move for the side to move, chosen in proportion to its weight.
+     * @param move Receives the move
+     * @return False if no book is set or the position is not in it.
+     */
+    bool bookHint(BookMove& move) const;
+
+    /**
+     * getPawnKey
+     *
+     * @return Zobrist key of the pawn configuration alone.
+     */
+    uint64_t getPawnKey() const { return pawnKey; }
+
     Player currentPlayer = WHITE; ///< Whose turn it is (WHITE starts)
 
 protected:
     int board[8][8]{}; ///< Internal board matrix of piece codes
 
+    EvalAccumulator accumulator; ///< Incremental material/piece-square totals
+    uint64_t pawnKey{0};         ///< Incremental pawn-only Zobrist key
+    PawnHashTable* pawnTable{&PawnHashTable::shared()}; ///< Pawn-structure cache
+    Tablebase* tablebase{nullptr}; ///< Optional endgame tablebase prober
+    const OpeningBook* openingBook{nullptr}; ///< Optional opening book
+
+    /**
+     * setSquare
+     *
+     * Writes a piece code to a square, keeping the evaluation accumulator
+     * and pawn key in step. All single-square board edits go through here.
+     * @param row   Row index (0-7)
+     * @param col   Column index (0-7)
+     * @param piece Piece code to place (0 empties the square)
+     */
+    void setSquare(int row, int col, int piece);
+
+    /**
+     * resetEvaluation
+     *
+     * Recomputes the accumulator and pawn key from the whole board; called after bulk
+     * loads such as loadBoard or FEN parsing.
+     */
+    void resetEvaluation();
+
     /**
      * isLegalKingMove
      *
@@ -258,6 +380,13 @@ signals:
      */
     void update_board();
 
+    /**
+     * piece_moved
+     *
+     * Emitted after every move, so the UI can play the move sound.
+     */
+    void piece_moved();
+
     /**
      * set_player
      *
@@ -1,8 +1,15 @@
 #include "chessboard.h"
 #include "qapplication.h"
 #include "confetticontroller.h"
+#include "glboardview.h"
+#include "frameclock.h"
+#include "assetmanager.h"
+#include "pieceset.h"
 #include <QPainter>
 #include <QDir>
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
 #include <iostream>
 #include "chess.h"
 
@@ -11,123 +18,348 @@ using std::endl;
 ChessBoard::ChessBoard(QWidget *parent)
     : QWidget(parent) {
 
-    image.load(":/Assets/Assets/Board.png");
+    loadAssets();
 
-    blackPawn.load(":/Assets/Assets/BlackPawn.png");
-    blackRook.load(":/Assets/Assets/BlackRook.png");
-    blackBishop.load(":/Assets/Assets/BlackBishop.png");
-    blackKnight.load(":/Assets/Assets/BlackKnight.png");
-    blackQueen.load(":/Assets/Assets/BlackQueen.png");
-    blackKing.load(":/Assets/Assets/BlackKing.png");
+    setMinimumSize(160, 160);
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
 
-    whitePawn.load(":/Assets/Assets/WhitePawn.png");
-    whiteRook.load(":/Assets/Assets/WhiteRook.png");
-    whiteBishop.load(":/Assets/Assets/WhiteBishop.png");
-    whiteKnight.load(":/Assets/Assets/WhiteKnight.png");
-    whiteQueen.load(":/Assets/Assets/WhiteQueen.png");
-    whiteKing.load(":/Assets/Assets/WhiteKing.png");
+    connect(&FrameClock::shared(), &FrameClock::frameFinished, this, &ChessBoard::flushRepaint);
+}
 
+void ChessBoard::loadAssets() {
+    AssetManager& assets = AssetManager::shared();
+    assets.load(":/Assets/Assets/Board.png", this, [this](const QImage& img) {
+        image = img;
+        if (--assetsPending == 0) assetsArrived();
+    });
 
+    // Atlas order: white then black, each PAWN..KING by piece code
+    static const char* names[12]{
+        "WhitePawn", "WhiteRook", "WhiteKnight", "WhiteBishop", "WhiteQueen", "WhiteKing",
+        "BlackPawn", "BlackRook", "BlackKnight", "BlackBishop", "BlackQueen", "BlackKing"
+    };
+    for (int i = 0; i < 12; ++i) {
+        assets.load(QString(":/Assets/Assets/%1.png").arg(names[i]), this, [this, i](const QImage& img) {
+            pieceImages[i] = img;
+            if (--assetsPending == 0) assetsArrived();
+        });
+    }
+}
 
-    setFixedSize(520, 520);
+void ChessBoard::assetsArrived() {
+    // Swap everything at once rather than popping pieces in one by one
+    spriteCache.clear();
+    pieceAtlas = QPixmap();
+    atlasCell = 0;
+    pieceCell = 0;
+    if (glView)
+        glView->reloadTextures();
+    invalidateStaticLayer();
+    update();
+}
+
+QImage ChessBoard::boardSource() const {
+    if (!image.isNull()) return image;
+
+    QImage grid(8, 8, QImage::Format_ARGB32_Premultiplied);
+    for (int i = 0; i < 8; ++i)
+        for (int j = 0; j < 8; ++j)
+            grid.setPixel(j, i, (i + j) % 2 ? qRgb(181, 136, 99) : qRgb(240, 217, 181));
+    return grid.scaled(256, 256);  // nearest neighbour keeps the edges sharp
+}
+
+QImage ChessBoard::pieceSource(int cell) const {
+    if (PieceSet::shared().isLoaded()) return PieceSet::shared().render(cell, 256);
+    if (!pieceImages[cell].isNull()) return pieceImages[cell];
+
+    static const char letters[] = "PRNBQK";
+    bool white = cell < 6;
+    QImage disc(128, 128, QImage::Format_ARGB32_Premultiplied);
+    disc.fill(Qt::transparent);
+    QPainter p(&disc);
+    p.setRenderHint(QPainter::Antialiasing);
+    p.setPen(QPen(Qt::black, 4));
+    p.setBrush(white ? QColor(245, 245, 245) : QColor(40, 40, 40));
+    p.drawEllipse(QRectF(20, 20, 88, 88));
+    QFont font = p.font();
+    font.setPixelSize(56);
+    font.setBold(true);
+    p.setFont(font);
+    p.setPen(white ? Qt::black : Qt::white);
+    p.drawText(disc.rect(), Qt::AlignCenter, QString(QChar(letters[cell % 6])));
+    return disc;
 }
 
 void ChessBoard::mousePressEvent(QMouseEvent *event){
-    int col{event->pos().x() / 50};
-    int row{event->pos().y() / 50};
+    QPoint local = event->pos() - boardOrigin;
+    if (local.x() < 0 || local.y() < 0) return;
+    int col{local.x() / squareSize};
+    int row{local.y() / squareSize};
+    if (row > 7 || col > 7) return;
 
     emit squareSelected(row, col);
 }
 
 void ChessBoard::setHintSquares(int fr, int fc, int tr, int tc) {
+    QRegion before = hintRegion();
     hintMoveFr = fr; hintMoveFc = fc;
     hintMoveTr = tr; hintMoveTc = tc;
     hasHintMove = true;
-    update();
+    scheduleRepaint(before + hintRegion());
 }
 
 void ChessBoard::clearHintMove() {
+    QRegion before = hintRegion();
     hasHintMove = false;
-    update();
+    scheduleRepaint(before);
 }
 
 void ChessBoard::clearHint() {
+    QRegion before = hintRegion();
     hasHint = false;
-    update();
+    scheduleRepaint(before);
+}
+
+QRegion ChessBoard::hintRegion() const {
+    QRegion region;
+    if (hasHintMove)
+        region += squareRect(hintMoveFr, hintMoveFc) | squareRect(hintMoveTr, hintMoveTc);
+    if (hasHint)
+        region += squareRect(hintFr, hintFc);
+    return region;
 }
 
+void ChessBoard::resizeEvent(QResizeEvent *event) {
+    QWidget::resizeEvent(event);
+    if (glView)
+        glView->setGeometry(rect());
+    updateLayout();
+    rebuildSpriteAtlas();
+}
 
-void ChessBoard::paintEvent(QPaintEvent *event) {
-    QPainter painter(this);
-    int x = 0;     // X coordinate
-    int y = 0;      // Y coordinate
-    int w = 520;     // Width of the board
-    int h = 520;     // Height of the board
+void ChessBoard::showEvent(QShowEvent *event) {
+    QWidget::showEvent(event);
+    attachFrameSource();
+}
+
+void ChessBoard::attachFrameSource() {
+    // Frames follow whatever actually presents the board
+    if (glView)
+        FrameClock::shared().setFrameSource(glView);
+    else
+        FrameClock::shared().setFrameSource(window()->windowHandle());
+}
+
+void ChessBoard::updateLayout() {
+    squareSize = qMax(1, qMin(width(), height()) / 8);
+    boardOrigin = QPoint((width() - 8 * squareSize) / 2, (height() - 8 * squareSize) / 2);
+    invalidateStaticLayer();
+}
+
+void ChessBoard::setRenderer(Renderer renderer) {
+    if (renderer == this->renderer()) return;
+
+    if (renderer == Renderer::OpenGL) {
+        glView = new BoardGLView(this);
+        glView->setGeometry(rect());
+        connect(glView, &BoardGLView::initFailed, this, [this]() {
+            // Can't delete the view from inside its own initializeGL
+            QMetaObject::invokeMethod(this, [this]() { setRenderer(Renderer::Raster); },
+                                      Qt::QueuedConnection);
+        });
+        glView->show();
+    } else {
+        delete glView;
+        glView = nullptr;
+        invalidateStaticLayer();
+        update();
+    }
+    attachFrameSource();
+}
+
+void ChessBoard::scheduleRepaint(const QRegion& region) {
+    // Inside a clock tick several animations may ask; paint once at the end
+    if (FrameClock::shared().inFrame()) {
+        pendingRepaint += region;
+        return;
+    }
+    if (glView)
+        glView->update();
+    else
+        update(region);
+}
+
+void ChessBoard::flushRepaint() {
+    if (pendingRepaint.isEmpty()) return;
+    QRegion region = pendingRepaint;
+    pendingRepaint = QRegion();
+    scheduleRepaint(region);
+}
+
+bool ChessBoard::slidingPiece(QRectF& rect, int& piece) const {
+    if (!slide.active) return false;
+    QRectF from = squareRect(slide.fromRow, slide.fromCol);
+    QRectF to = squareRect(slide.toRow, slide.toCol);
+    rect = from.translated((to.topLeft() - from.topLeft()) * slide.progress);
+    piece = slide.piece;
+    return true;
+}
+
+void ChessBoard::startSlide(int fromRow, int fromCol, int toRow, int toCol, int piece, int captured) {
+    if (slide.active) finishSlide();
+
+    slide.active = true;
+    slide.fromRow = fromRow; slide.fromCol = fromCol;
+    slide.toRow = toRow;     slide.toCol = toCol;
+    slide.piece = piece;
+    slide.captured = captured;
+    slide.start = FrameClock::shared().now();
+    slide.progress = 0.0f;
+
+    FrameClock::shared().animate(this, [this](qint64 now, float) {
+        QRectF before;
+        int piece;
+        slidingPiece(before, piece);
+
+        float t = qMin(1.0f, float(now - slide.start) / kSlideMs);
+        slide.progress = 1.0f - (1.0f - t) * (1.0f - t) * (1.0f - t);  // ease out
+
+        QRectF after;
+        slidingPiece(after, piece);
+        scheduleRepaint(QRegion(before.toAlignedRect()) + after.toAlignedRect());
+
+        if (t < 1.0f) return true;
+        finishSlide();
+        return false;
+    });
+}
+
+void ChessBoard::finishSlide() {
+    if (!slide.active) return;
+    slide.active = false;
+    squareDirty[slide.toRow][slide.toCol] = true;
+    scheduleRepaint(squareRect(slide.toRow, slide.toCol));
+}
+
+int ChessBoard::atlasIndex(int piece) {
+    if (piece == 0) return -1;
+    return (piece > 0 ? 0 : 6) + std::abs(piece) - 1;
+}
+
+void ChessBoard::rebuildSpriteAtlas() {
+    atlasDpr = devicePixelRatioF();
+    int exact = qMax(1, qRound(squareSize * atlasDpr));
+    int bucket = (exact + kSizeBucket - 1) / kSizeBucket * kSizeBucket;
+    PieceSet& svg = PieceSet::shared();
+    int wantPieces = svg.isLoaded() ? exact : bucket;
+    if (bucket == atlasCell && wantPieces == pieceCell && !pieceAtlas.isNull()) return;
 
-    // Draw the image scaled to size at the specified coordinates
-    painter.drawImage(QRect(x, y, 400, 400), image);
+    auto found = spriteCache.find(bucket);
+    if (found == spriteCache.end()) {
+        SpriteSet set;
+        set.board = QPixmap::fromImage(boardSource().scaled(8 * bucket, 8 * bucket,
+                                                    Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
 
+        // SVG pieces are rasterized per exact size instead, see below
+        if (!svg.isLoaded()) {
+            QImage atlas(12 * bucket, bucket, QImage::Format_ARGB32_Premultiplied);
+            atlas.fill(Qt::transparent);
+            QPainter p(&atlas);
+            for (int i = 0; i < 12; ++i) {
+                p.drawImage(QPoint(i * bucket, 0),
+                            pieceSource(i).scaled(bucket, bucket,
+                                                  Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
+            }
+            p.end();
+            set.pieces = QPixmap::fromImage(atlas);
+        }
+
+        // Keep the few sets nearest the new size
+        while (spriteCache.size() >= kMaxSpriteSets) {
+            auto farthest = std::max_element(spriteCache.begin(), spriteCache.end(),
+                [bucket](const auto& a, const auto& b) {
+                    return std::abs(a.first - bucket) < std::abs(b.first - bucket);
+                });
+            spriteCache.erase(farthest);
+        }
+        found = spriteCache.emplace(bucket, set).first;
+    }
+
+    boardPixmap = found->second.board;
+    pieceAtlas = svg.isLoaded() ? svg.atlas(exact) : found->second.pieces;
+    atlasCell = bucket;
+    pieceCell = wantPieces;
+    invalidateStaticLayer();
+}
+
+void ChessBoard::renderStaticLayer() {
+    if (staticDirty || staticLayer.size() != size() * atlasDpr) {
+        staticLayer = QPixmap(size() * atlasDpr);
+        staticLayer.setDevicePixelRatio(atlasDpr);
+        staticLayer.fill(Qt::transparent);
+        for (auto& row : squareDirty)
+            std::fill(std::begin(row), std::end(row), true);
+    }
+
+    // Sprites are bucketed, so they may be a few device pixels larger than
+    // the square and need a smooth downscale.
+    QPainter painter(&staticLayer);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
     for (int i = 0; i < 8; ++i){
         for (int j = 0; j < 8; ++j){
-            switch (puzzleBoard[i][j]){
-                case PAWN:
-                    painter.drawImage(QRect(x  + 50*j, y  + 50*i, 50, 50), whitePawn);
-                    break;
-                case ROOK:
-                    painter.drawImage(QRect(x  + 50*j, y  + 50*i, 50, 50), whiteRook);
-                    break;
-                case KNIGHT:
-                    painter.drawImage(QRect(x  + 50*j, y  + 50*i, 50, 50), whiteKnight);
-                    break;
-                case BISHOP:
-                    painter.drawImage(QRect(x  + 50*j, y  + 50*i, 50, 50), whiteBishop);
-                    break;
-                case QUEEN:
-                    painter.drawImage(QRect(x  + 50*j, y  + 50*i, 50, 50), whiteQueen);
-                    break;
-                case KING:
-                    painter.drawImage(QRect(x  + 50*j, y  + 50*i, 50, 50), whiteKing);
-                    break;
-
-                // Black
-                case -PAWN:
-                    painter.drawImage(QRect(x  + 50*j, y  + 50*i, 50, 50), blackPawn);
-                    break;
-                case -ROOK:
-                    painter.drawImage(QRect(x  + 50*j, y  + 50*i, 50, 50), blackRook);
-                    break;
-                case -KNIGHT:
-                    painter.drawImage(QRect(x  + 50*j, y  + 50*i, 50, 50), blackKnight);
-                    break;
-                case -BISHOP:
-                    painter.drawImage(QRect(x  + 50*j, y  + 50*i, 50, 50), blackBishop);
-                    break;
-                case -QUEEN:
-                    painter.drawImage(QRect(x  + 50*j, y  + 50*i, 50, 50), blackQueen);
-                    break;
-                case -KING:
-                    painter.drawImage(QRect(x  + 50*j, y  + 50*i, 50, 50), blackKing);
-                    break;
-            }
+            if (!squareDirty[i][j]) continue;
+            squareDirty[i][j] = false;
+
+            // Restore the background under the square, then the piece
+            QRect target = squareRect(i, j);
+            painter.setCompositionMode(QPainter::CompositionMode_Source);
+            painter.drawPixmap(target, boardPixmap,
+                               QRect(j * atlasCell, i * atlasCell, atlasCell, atlasCell));
+            painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+
+            int cell = atlasIndex(displayedPiece(i, j));
+            if (cell < 0) continue;
+            painter.drawPixmap(target, pieceAtlas,
+                               QRect(cell * pieceCell, 0, pieceCell, pieceCell));
         }
     }
+    staticDirty = false;
+}
 
-    if (hasHintMove) {
-        QColor overlay(255,255,0,100);
-        painter.setBrush(overlay);
-        painter.setPen(Qt::NoPen);
-        // draw from‐square
-        painter.drawRect(hintMoveFc*50, hintMoveFr*50, 50, 50);
-        // draw to‐square
-        painter.drawRect(hintMoveTc*50, hintMoveTr*50, 50, 50);
+void ChessBoard::paintEvent(QPaintEvent *event) {
+    // The OpenGL view covers the widget and draws everything itself
+    if (glView && glView->isUsable())
+        return;
+
+    // Moving the window to a screen with another scale factor does not
+    // resize it, so check the ratio here too.
+    if (pieceAtlas.isNull() || devicePixelRatioF() != atlasDpr) {
+        updateLayout();
+        rebuildSpriteAtlas();
     }
 
-    if (hasHint) {
+    renderStaticLayer();
+
+    // Board and pieces come from the cache; only overlays are drawn live.
+    QPainter painter(this);
+    painter.drawPixmap(0, 0, staticLayer);
+
+    QRegion hints = hintRegion();
+    if (!hints.isEmpty()) {
         QColor overlay(255,255,0,100);
         painter.setBrush(overlay);
         painter.setPen(Qt::NoPen);
-        // draw from‐square
-        painter.drawRect(hintFc*50, hintFr*50, 50, 50);
+        for (const QRect& r : hints)
+            painter.drawRect(r);
+    }
+
+    QRectF slideRect;
+    int slidePiece;
+    if (slidingPiece(slideRect, slidePiece)) {
+        painter.setRenderHint(QPainter::SmoothPixmapTransform);
+        int cell = atlasIndex(slidePiece);
+        painter.drawPixmap(slideRect, pieceAtlas,
+                           QRectF(cell * pieceCell, 0, pieceCell, pieceCell));
     }
 
     if (confetti) {
@@ -138,9 +370,35 @@ void ChessBoard::paintEvent(QPaintEvent *event) {
 }
 
 void ChessBoard::setBoardState(int pb[8][8]){
-    for (int i = 0; i < 8; ++i)
-        for (int j = 0; j < 8; ++j)
+    applyBoardState(pb);
+}
+
+void ChessBoard::applyBoardState(const int pb[8][8]){
+    // A new position ends any slide still in flight
+    finishSlide();
+
+    // Only squares whose piece changed need repainting; a normal move is two.
+    QRegion changed;
+    int vacated = 0, arrived = 0;
+    int fromRow = 0, fromCol = 0, toRow = 0, toCol = 0, captured = 0;
+    for (int i = 0; i < 8; ++i){
+        for (int j = 0; j < 8; ++j){
+            if (puzzleBoard[i][j] == pb[i][j]) continue;
+            if (pb[i][j] == 0) { ++vacated; fromRow = i; fromCol = j; }
+            else { ++arrived; toRow = i; toCol = j; captured = puzzleBoard[i][j]; }
             puzzleBoard[i][j] = pb[i][j];
+            squareDirty[i][j] = true;
+            changed += squareRect(i, j);
+        }
+    }
+
+    // Exactly one piece left one square and appeared on another: slide it
+    bool oneMove = vacated == 1 && arrived == 1;
+    if (animateMoves && oneMove && isVisible())
+        startSlide(fromRow, fromCol, toRow, toCol, pb[toRow][toCol], captured);
+
+    if (!changed.isEmpty())
+        scheduleRepaint(changed);
 }
 
 std::vector<std::vector<int>> ChessBoard::getBoardState() const {
@@ -153,10 +411,11 @@ std::vector<std::vector<int>> ChessBoard::getBoardState() const {
 
 void ChessBoard::setBoardState(const std::vector<std::vector<int>>& pb) {
     // assume pb.size()==8 && pb[i].size()==8
+    int next[8][8];
     for(int i = 0; i < 8; ++i) {
         for(int j = 0; j < 8; ++j) {
-            puzzleBoard[i][j] = pb[i][j];
+            next[i][j] = pb[i][j];
         }
     }
-    update();  // trigger repaint
+    applyBoardState(next);
 }
@@ -13,11 +13,15 @@
 
 #include <QWidget>
 #include <QImage>
+#include <QPixmap>
+#include <QRegion>
 #include <QMouseEvent>
+#include <map>
 #include <vector>
 #include <QPainter>
 
 class ConfettiController;
+class BoardGLView;
 
 /**
  * ChessBoard
@@ -28,8 +32,15 @@ class ConfettiController;
  */
 class ChessBoard : public QWidget {
     Q_OBJECT
+    friend class BoardGLView;
 
 public:
+    /// Available render paths
+    enum class Renderer {
+        Raster,  ///< QPainter with cached pixmaps (default)
+        OpenGL   ///< BoardGLView child widget, falls back to Raster on failure
+    };
+
     /**
      * Constructor
      *
@@ -40,12 +51,31 @@ public:
     /**
      * Paint event
      *
-     * Called by Qt to repaint the board, pieces, hints, and confetti.
+     * Called by Qt to repaint. Composites the cached board + pieces layer,
+     * then hint overlays and confetti on top.
      *
      * @param event Paint event details (ignored).
      */
     void paintEvent(QPaintEvent *event) override;
 
+    /**
+     * Resize event
+     *
+     * Rebuilds the sprite atlas for the new size.
+     *
+     * @param event Resize event details (ignored).
+     */
+    void resizeEvent(QResizeEvent *event) override;
+
+    /**
+     * Show event
+     *
+     * Once the board has a native window, paces the frame clock by it.
+     *
+     * @param event Show event details (ignored).
+     */
+    void showEvent(QShowEvent *event) override;
+
     /**
      * setBoardState
      *
@@ -109,6 +139,96 @@ public:
      */
     void clearHint();
 
+    /**
+     * setRenderer
+     *
+     * Switch between the QPainter path and the OpenGL view.
+     *
+     * @param renderer Render path to use.
+     */
+    void setRenderer(Renderer renderer);
+
+    /**
+     * renderer
+     *
+     * @return Render path currently in use.
+     */
+    Renderer renderer() const { return glView ? Renderer::OpenGL : Renderer::Raster; }
+
+    /**
+     * scheduleRepaint
+     *
+     * Request a repaint of part of the board through whichever render path
+     * is active. The OpenGL path always redraws the whole frame.
+     *
+     * @param region Area that changed, in widget coordinates.
+     */
+    void scheduleRepaint(const QRegion& region);
+
+    /**
+     * squareRect
+     *
+     * @return Widget-space rectangle of a board square.
+     */
+    QRect squareRect(int row, int col) const {
+        return QRect(boardOrigin.x() + squareSize*col, boardOrigin.y() + squareSize*row,
+                     squareSize, squareSize);
+    }
+
+    /**
+     * squareSide
+     *
+     * @return Side of one square in logical pixels for the current size.
+     */
+    int squareSide() const { return squareSize; }
+
+    /**
+     * worldToWidget
+     *
+     * Map physics-world metres (one metre per square, y up, origin at the
+     * bottom-left corner of the board) to widget pixels.
+     */
+    QPointF worldToWidget(float x, float y) const {
+        return QPointF(boardOrigin.x() + x * squareSize, boardOrigin.y() + (8.0f - y) * squareSize);
+    }
+
+    /**
+     * sizeHint
+     *
+     * @return Preferred size: 50 px squares.
+     */
+    QSize sizeHint() const override { return QSize(400, 400); }
+
+    /**
+     * setAnimateMoves
+     *
+     * Slide a piece to its new square when setBoardState changes exactly
+     * one move's worth of squares, instead of snapping.
+     *
+     * @param on True to animate (default).
+     */
+    void setAnimateMoves(bool on) { animateMoves = on; }
+
+    /**
+     * displayedPiece
+     *
+     * Piece the static layer shows on a square; while a slide is running
+     * the destination keeps its old occupant until the mover arrives.
+     */
+    int displayedPiece(int row, int col) const {
+        return (slide.active && row == slide.toRow && col == slide.toCol)
+                   ? slide.captured : puzzleBoard[row][col];
+    }
+
+    /**
+     * slidingPiece
+     *
+     * @param rect  Receives where the moving piece is drawn this frame.
+     * @param piece Receives its piece code.
+     * @return False when no slide is running.
+     */
+    bool slidingPiece(QRectF& rect, int& piece) const;
+
 private:
     bool   hasHintMove = false; ///< True if a two-square hint is shown
     bool   hasHint     = false; ///< True if a single-square hint is shown
@@ -119,21 +239,136 @@ private:
     int    hintFr;              ///< Row for simple hint overlay
     int    hintFc;              ///< Col for simple hint overlay
 
-    QImage image;         ///< Background board image
-    QImage blackPawn;     ///< Black pawn image
-    QImage blackRook;     ///< Black rook image
-    QImage blackBishop;   ///< Black bishop image
-    QImage blackKnight;   ///< Black knight image
-    QImage blackQueen;    ///< Black queen image
-    QImage blackKing;     ///< Black king image
-    QImage whitePawn;     ///< White pawn image
-    QImage whiteRook;     ///< White rook image
-    QImage whiteBishop;   ///< White bishop image
-    QImage whiteKnight;   ///< White knight image
-    QImage whiteQueen;    ///< White queen image
-    QImage whiteKing;     ///< White king image
+    QImage image;            ///< Background board image, null until decoded
+    QImage pieceImages[12];  ///< Source piece images in atlas order, null until decoded
+    int    assetsPending{13};///< Images still being decoded by the AssetManager
+
+    /**
+     * loadAssets
+     *
+     * Queue the board and piece images for background decoding. Until all
+     * of them arrive the board draws placeholders.
+     */
+    void loadAssets();
+
+    /**
+     * assetsArrived
+     *
+     * Drop sprites built from placeholders and redraw with the real images.
+     */
+    void assetsArrived();
 
-    int puzzleBoard[8][8]; ///< Internal board state array
+    /**
+     * boardSource
+     *
+     * @return The board image, or a plain two-tone grid while it loads.
+     */
+    QImage boardSource() const;
+
+    /**
+     * pieceSource
+     *
+     * @param cell Atlas cell (see atlasIndex).
+     * @return The piece image, or a lettered disc while it loads.
+     */
+    QImage pieceSource(int cell) const;
+
+    /**
+     * SpriteSet
+     *
+     * Board and piece sprites pre-scaled for one size bucket.
+     */
+    struct SpriteSet {
+        QPixmap board;   ///< Background, 8 cells square
+        QPixmap pieces;  ///< All 12 pieces side by side
+    };
+
+    std::map<int, SpriteSet> spriteCache;  ///< Sprite sets by cell size bucket (device px)
+    QPixmap boardPixmap;     ///< Background for the bucket in use
+    QPixmap pieceAtlas;      ///< Pieces for the bucket in use, or the exact size for SVG pieces
+    qreal   atlasDpr{0};     ///< Device pixel ratio the sprites were chosen for
+    int     atlasCell{0};    ///< Width/height of one board sprite cell in device pixels
+    int     pieceCell{0};    ///< Width/height of one piece in pieceAtlas in device pixels
+
+    QPoint  boardOrigin;     ///< Top-left of the board in the widget
+    int     squareSize{50};  ///< Side of a square in logical pixels
+
+    /// Sprite cells are built in steps of this many device pixels
+    static constexpr int kSizeBucket = 16;
+    /// Sprite sets kept around for sizes recently used
+    static constexpr std::size_t kMaxSpriteSets = 3;
+
+    QPixmap staticLayer;        ///< Cached board + pieces, composited under overlays
+    bool    staticDirty{true};  ///< True when all of staticLayer must be redrawn
+    bool    squareDirty[8][8]{};///< Squares of staticLayer to redraw on the next paint
+
+    /**
+     * updateLayout
+     *
+     * Recompute square size and board origin from the widget size: the
+     * largest whole-pixel board that fits, centred.
+     */
+    void updateLayout();
+
+    /**
+     * attachFrameSource
+     *
+     * Pace the FrameClock by the OpenGL view's swaps when that renderer is
+     * active, otherwise by the top-level window's update requests.
+     */
+    void attachFrameSource();
+
+    /**
+     * rebuildSpriteAtlas
+     *
+     * Pick (building if needed) the sprite set for the current square size
+     * and device pixel ratio. Sizes are bucketed so a live resize reuses a
+     * set instead of rescaling the source images on every step. With an
+     * SVG piece set loaded, pieces come from PieceSet at the exact size.
+     */
+    void rebuildSpriteAtlas();
+
+    /**
+     * atlasIndex
+     *
+     * @param piece Signed piece code
+     * @return Cell of the piece in pieceAtlas, -1 for an empty square.
+     */
+    static int atlasIndex(int piece);
+
+    /**
+     * renderStaticLayer
+     *
+     * Redraw the board background and pieces into staticLayer. Only needed
+     * after the position, size or pixel ratio changed.
+     */
+    void renderStaticLayer();
+
+    /**
+     * invalidateStaticLayer
+     *
+     * Mark the cached board + pieces as stale for the next paint.
+     */
+    void invalidateStaticLayer() { staticDirty = true; }
+
+    /**
+     * hintRegion
+     *
+     * @return Area covered by the hint overlays currently shown.
+     */
+    QRegion hintRegion() const;
+
+    /**
+     * applyBoardState
+     *
+     * Copy a new position in, mark the squares that changed in the static
+     * layer and repaint only those.
+     *
+     * @param pb 8×8 array of piece codes.
+     */
+    void applyBoardState(const int pb[8][8]);
+
+    int puzzleBoard[8][8]{}; ///< Internal board state array
 
     /**
      * mousePressEvent
@@ -147,6 +382,49 @@ private:
 
     bool selected{false}; ///< True if a piece is currently selected
     ConfettiController* confetti = nullptr; ///< Confetti animation controller
+    BoardGLView* glView = nullptr;          ///< OpenGL view, when that renderer is active
+
+    /**
+     * Slide
+     *
+     * Piece moving between two squares, advanced by the FrameClock.
+     */
+    struct Slide {
+        bool   active{false};
+        int    fromRow{0}, fromCol{0};
+        int    toRow{0}, toCol{0};
+        int    piece{0};      ///< Moving piece code
+        int    captured{0};   ///< Piece shown on the destination until arrival
+        qint64 start{0};      ///< FrameClock time the slide began
+        float  progress{0};   ///< Eased 0..1
+    } slide;
+
+    bool    animateMoves{true};  ///< Slide single moves instead of snapping
+    QRegion pendingRepaint;      ///< Repaints requested during a clock tick
+
+    /// Length of a piece slide in milliseconds
+    static constexpr int kSlideMs = 180;
+
+    /**
+     * startSlide
+     *
+     * Begin animating a piece from one square to another.
+     */
+    void startSlide(int fromRow, int fromCol, int toRow, int toCol, int piece, int captured);
+
+    /**
+     * finishSlide
+     *
+     * Drop the moving piece onto its square and stop the animation.
+     */
+    void finishSlide();
+
+    /**
+     * flushRepaint
+     *
+     * Issue the repaint collected during a frame, once.
+     */
+    void flushRepaint();
 
 signals:
     /**
@@ -1,8 +1,8 @@
 #include "chesspuzzle.h"
+#include "tablebase.h"
 #include <iostream>
 #include <sstream>
-#include <QTimer>
-#include <QSoundEffect>
+#include "frameclock.h"
 
 using std::endl;
 using std::cout;
@@ -107,6 +107,7 @@ void ChessPuzzle::loadFEN(const string& FEN){
             col++;
         }
     }
+    resetEvaluation();
     if (startingPlayer == "b"){
         currentPlayer = BLACK;
     }
@@ -181,17 +182,12 @@ bool ChessPuzzle::makeGuess(Square from, Square to) {
         cout << "current step: " << currentStep << endl;
         if(currentStep == solutionMoves.size()){
             if (debugging) cout << "Beat the puzzle" << endl;
-            // play sound effect
             emit beatPuzzle();
-            QSoundEffect *effect = new QSoundEffect;
-            effect->setSource(QUrl("qrc:/Assets/Assets/Confetti.wav"));
-            effect->setVolume(1);
-            effect->play();
             return true;
         }
         else{
             if (debugging) cout << "Correct move, opponent will now move" << endl;
-            QTimer::singleShot(1000, this, &ChessPuzzle::makeOpponentMove);
+            FrameClock::shared().schedule(1000, this, [this]() { makeOpponentMove(); });
             return true;
         }
     }
@@ -205,6 +201,32 @@ bool ChessPuzzle::isSolved() const {
     return currentStep >= solutionMoves.size();
 }
 
+bool ChessPuzzle::agreesWithTablebase() {
+    if (!tablebase) return true;
+
+    // Play the rest of the line silently, then take it all back
+    vector<MoveUndo> played;
+    bool agrees = true;
+    for (size_t step = currentStep; step < solutionMoves.size() && agrees; ++step) {
+        const auto& mv = solutionMoves[step];
+        // Opponent moves sit at even steps, the player's at odd steps
+        bool playerMove = step % 2 == 1;
+        int before = 0;
+        bool probed = playerMove && tablebase->probeWdl(board, currentPlayer, before);
+
+        played.push_back(makeMove(mv.first, mv.second));
+
+        int after = 0;
+        if (probed && tablebase->probeWdl(board, currentPlayer, after) && -after < before) {
+            if (debugging) cout << "Tablebase rejects " << mv.first << " -> " << mv.second << endl;
+            agrees = false;
+        }
+    }
+    for (auto it = played.rbegin(); it != played.rend(); ++it)
+        unmakeMove(*it);
+    return agrees;
+}
+
 std::pair<Square,Square> ChessPuzzle::peekNextMove() const {
     return solutionMoves[currentStep];
 }
@@ -139,6 +139,15 @@ public:
      */
     std::pair<Square,Square> peekNextMove() const;
 
+    /**
+     * Check the remaining solution against the endgame tablebase set with
+     * setTablebase(): every player move must keep the best result that
+     * was available before it. Positions the tables don't cover pass.
+     *
+     * @return False if a solution move throws away a win or draw
+     */
+    bool agreesWithTablebase();
+
     /**
      * Get the Elo rating assigned to this puzzle.
      *
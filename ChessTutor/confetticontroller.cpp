@@ -1,100 +1,339 @@
 #include "confetticontroller.h"
 #include <QElapsedTimer>
 #include "chessboard.h"
+#include "frameclock.h"
 #include <QPainter>
-#include <QTimer>
+#include <QPainterPath>
+#include <QVector>
+#include <algorithm>
+#include <cmath>
 #include <random>
+#include <Box2D/Common/b2ThreadPool.h>
 
-// color palette for particles
-const std::vector<QColor> ConfettiController::kPalette = {
-    QColor(0x0079FF), QColor(0x00DFA2), QColor(0xF6FA70),
-    QColor(0x0079FF), QColor(0x00DFA2), QColor(0xFF0060)
+namespace {
+
+// Island solver workers shared by every controller; all step on the GUI thread
+b2ThreadPool& solverThreads() {
+    static b2ThreadPool pool;
+    return pool;
+}
+
+} // namespace
+
+// Cheapest last: fewer particles, then fewer solver iterations, then points
+const ConfettiController::Quality ConfettiController::kQuality[kQualityLevels] = {
+    { 1.0f,  false, 8, 3 },
+    { 0.6f,  false, 4, 2 },
+    { 0.35f, true,  2, 1 },
+    { 0.2f,  true,  1, 1 },
 };
 
 ConfettiController::ConfettiController(ChessBoard* board, QObject* parent)
     : QObject(parent),
     world(b2Vec2(0.0f, -0.5f)),   // gravity
-    timer(this),
-    board(board)
+    board(board),
+    m_emitter(std::random_device{}()),
+    m_governor(kQualityLevels, kDefaultBudgetMs)
 {
     m_clock.start();
-    connect(&timer, &QTimer::timeout, this, &ConfettiController::stepPhysics);
-    timer.start(16);  // ~60 Hz
+    m_parts.reserve(m_capacity);
+    m_system.setCapacity(m_capacity);
+    m_effects.load(":/Assets/Assets/effects.json");
+    setPhysicsProfile(m_profile);
+    world.SetThreadPool(&solverThreads());
+}
+
+void ConfettiController::wake() {
+    if (m_lastStepNs < 0) {
+        m_lastStepNs = m_clock.nsecsElapsed();
+        m_accumulator = 0.0f;
+    }
+    FrameClock::shared().animate(this, [this](qint64, float) { return stepPhysics(); });
 }
 
 ConfettiController::~ConfettiController() {
     for (auto &p : m_parts)
         world.DestroyBody(p.body);
+    for (b2Body* b : m_spare)
+        world.DestroyBody(b);
+    if (m_floor)
+        world.DestroyBody(m_floor);
 }
 
-void ConfettiController::spawn(int count) {
-    std::mt19937 rng{ std::random_device{}() };
-    std::uniform_real_distribution<float> xDist(0.0f, 8.0f);
-    std::uniform_real_distribution<float> sizeDist(0.03f, 0.08f);
-    std::uniform_real_distribution<float> angDist(-3.0f, 3.0f);
-    std::uniform_int_distribution<int> colDist(0, int(kPalette.size()) - 1);
-    float now = m_clock.elapsed() * 0.001f;
+void ConfettiController::setPhysicsProfile(const PhysicsProfile& profile) {
+    m_profile = profile;
+    world.SetAllowSleeping(profile.allowSleep);
+    world.SetSleepTolerance(profile.linearSleepTolerance, profile.angularSleepTolerance,
+                            profile.timeToSleep);
+    // Time-of-impact solving only matters if there is something to hit
+    world.SetContinuousPhysics(needsFixtures());
+
+    if (profile.floor && !m_floor) {
+        b2BodyDef bd{ };
+        m_floor = world.CreateBody(&bd);
+        b2EdgeShape edge;
+        edge.Set(b2Vec2(-1.0f, 0.0f), b2Vec2(9.0f, 0.0f));
+        b2FixtureDef fd{ };
+        fd.shape = &edge;
+        fd.friction = 0.6f;
+        fd.filter.categoryBits = kWorldCategory;
+        m_floor->CreateFixture(&fd);
+    } else if (!profile.floor && m_floor) {
+        world.DestroyBody(m_floor);
+        m_floor = nullptr;
+    }
 
-    for (int i = 0; i < count; ++i) {
-        b2BodyDef body{ };
-        body.type = b2_dynamicBody;
-        body.position.Set(xDist(rng), 12.0f);
-        b2Body* object_body = world.CreateBody(&body);
+    // Parked bodies may have the wrong fixtures; live ones are updated
+    for (b2Body* b : m_spare)
+        world.DestroyBody(b);
+    m_spare.clear();
+    const b2Filter filter = particleFilter();
+    for (auto &p : m_parts) {
+        if (b2Fixture* f = p.body->GetFixtureList())
+            f->SetFilterData(filter);
+        if (!profile.bullets)
+            p.body->SetBullet(false);
+    }
+}
 
-        float half = sizeDist(rng);
-        b2PolygonShape box; box.SetAsBox(half, half);
-        b2FixtureDef fix;
-        fix.shape = &box;
-        fix.density = 1.0f;
-        fix.restitution = 0.4f + 0.2f * (rng() % 100 / 100.0f);
-        object_body->CreateFixture(&fix);
+b2Filter ConfettiController::particleFilter() const {
+    b2Filter filter;
+    filter.categoryBits = kParticleCategory;
+    filter.maskBits = m_profile.particleCollisions ? kWorldCategory | kParticleCategory
+                                                   : kWorldCategory;
+    return filter;
+}
 
-        object_body->SetLinearVelocity({ (xDist(rng) - 4.0f), -2.0f });
-        object_body->SetAngularVelocity(angDist(rng));
-        object_body->SetLinearDamping(1.5f);
-        object_body->SetAngularDamping(0.3f);
+void ConfettiController::setBackend(Backend backend) {
+    if (backend == m_backend) return;
+    for (auto &p : m_parts)
+        world.DestroyBody(p.body);
+    for (b2Body* b : m_spare)
+        world.DestroyBody(b);
+    m_parts.clear();
+    m_spare.clear();
+    m_system.clear();
+    m_running.clear();
+    m_backend = backend;
+    if (m_backend == Backend::Particles)
+        m_system.setCapacity(m_capacity);
+}
 
-        Particles p{ object_body, kPalette[colDist(rng)], half, now };
-        m_parts.push_back(p);
+void ConfettiController::setCapacity(std::size_t capacity) {
+    m_capacity = capacity;
+    // Keep live plus parked bodies within the cap
+    while (!m_spare.empty() && m_parts.size() + m_spare.size() > m_capacity) {
+        world.DestroyBody(m_spare.back());
+        m_spare.pop_back();
     }
+    m_parts.reserve(m_capacity);
+    if (m_backend == Backend::Particles)
+        m_system.setCapacity(m_capacity);
 }
 
-void ConfettiController::spawnAt(const b2Vec2& pos, int count) {
-    std::mt19937 rng{ std::random_device{}() };
-    std::uniform_real_distribution<float> sizeDist(0.03f, 0.08f);
-    std::uniform_real_distribution<float> angDist(-3.0f, 3.0f);
-    std::uniform_int_distribution<int> colDist(0, int(kPalette.size()) - 1);
-    float now = m_clock.elapsed() * 0.001f;
+std::size_t ConfettiController::particleCount() const {
+    return m_backend == Backend::Box2D ? m_parts.size() : m_system.size();
+}
+
+void ConfettiController::launch(const ParticleSpawn& s) {
+    if (particleCount() >= m_capacity) return;
+    if (m_backend == Backend::Particles) {
+        m_system.add(s);
+        return;
+    }
+
+    m_parts.push_back({ acquireBody(s), s.color, s.half, m_simTime, s.life, s.fade, b2Vec2(s.x, s.y), s.angle });
+}
 
-    for (int i = 0; i < count; ++i) {
+b2Body* ConfettiController::acquireBody(const ParticleSpawn& s) {
+    const bool bullet = s.bullet && m_profile.bullets;
+    if (m_spare.empty()) {
         b2BodyDef bd{ };
         bd.type = b2_dynamicBody;
-        bd.position = pos;
-        bd.bullet = true;
+        bd.position.Set(s.x, s.y);
+        bd.angle = s.angle;
+        bd.bullet = bullet;
+        bd.linearVelocity.Set(s.vx, s.vy);
+        bd.angularVelocity = s.spin;
+        bd.linearDamping = s.linearDamping;
+        bd.angularDamping = s.angularDamping;
+        bd.gravityScale = s.gravityScale;
         b2Body* b = world.CreateBody(&bd);
 
-        float half = sizeDist(rng);
-        b2PolygonShape box; box.SetAsBox(half, half);
+        // Nothing to touch: no fixture, so no broadphase proxy or contacts.
+        // Velocities are set directly, so the default mass is never used.
+        if (!needsFixtures())
+            return b;
+
+        b2PolygonShape box; box.SetAsBox(s.half, s.half);
         b2FixtureDef fd{ };
         fd.shape = &box;
         fd.density = 1.0f;
-        fd.restitution = 0.6f;
-        fd.friction = 0.2f;
+        fd.restitution = s.restitution;
+        fd.friction = s.friction;
+        fd.filter = particleFilter();
         b->CreateFixture(&fd);
+        return b;
+    }
+
+    // Reshape while inactive, so the broadphase proxy is built once on wake
+    b2Body* b = m_spare.back();
+    m_spare.pop_back();
+    if (b2Fixture* f = b->GetFixtureList()) {
+        static_cast<b2PolygonShape*>(f->GetShape())->SetAsBox(s.half, s.half);
+        f->SetRestitution(s.restitution);
+        f->SetFriction(s.friction);
+        b->ResetMassData();
+    }
+    b->SetTransform(b2Vec2(s.x, s.y), s.angle);
+    b->SetLinearVelocity(b2Vec2(s.vx, s.vy));
+    b->SetAngularVelocity(s.spin);
+    b->SetLinearDamping(s.linearDamping);
+    b->SetAngularDamping(s.angularDamping);
+    b->SetGravityScale(s.gravityScale);
+    b->SetBullet(bullet);
+    b->SetActive(true);
+    b->SetAwake(true);
+    return b;
+}
+
+void ConfettiController::releasePart(std::size_t i) {
+    // Inactive bodies leave the broadphase and drop their contacts
+    b2Body* b = m_parts[i].body;
+    b->SetActive(false);
+    m_spare.push_back(b);
+    m_parts[i] = m_parts.back();
+    m_parts.pop_back();
+}
+
+void ConfettiController::spawn(int count) {
+    play("solve", b2Vec2(4.0f, 12.0f), count);
+}
+
+void ConfettiController::spawnAt(const b2Vec2& pos, int count) {
+    play("capture", pos, count);
+}
+
+bool ConfettiController::play(const QString& name, const b2Vec2& at, int count) {
+    const EmitterPreset* preset = m_effects.find(name);
+    if (!preset) return false;
+
+    if (count < 0) count = preset->count;
+    emitPreset(*preset, at, int(count * quality().spawnScale + 0.5f));
+    if (preset->rate > 0.0f && preset->duration > 0.0f)
+        m_running.push_back({ *preset, at, preset->duration, 0.0f });
+    wake();
+    return true;
+}
+
+void ConfettiController::emitPreset(const EmitterPreset& preset, const b2Vec2& at, int count) {
+    // Never generate more than the budget can take
+    int room = int(m_capacity - qMin(m_capacity, particleCount()));
+    m_emitter.emit(preset, at.x, at.y, qMin(count, room), m_batch);
+    for (auto const& s : m_batch)
+        launch(s);
+}
+
+void ConfettiController::runEmitters(float step) {
+    for (std::size_t i = 0; i < m_running.size(); ) {
+        Running& r = m_running[i];
+        float active = qMin(step, r.remaining);
+        r.carry += r.preset.rate * quality().spawnScale * active;
+        int whole = int(r.carry);
+        r.carry -= whole;
+        if (whole > 0)
+            emitPreset(r.preset, r.at, whole);
+        r.remaining -= step;
+        if (r.remaining <= 0.0f) {
+            m_running[i] = m_running.back();
+            m_running.pop_back();
+        } else {
+            ++i;
+        }
+    }
+}
+
+template <typename F>
+void ConfettiController::forEachParticle(F&& f) const {
+    // Draw between the last two physics states, m_blend of the way along
+    const float t = m_blend;
+    const std::vector<QColor>& palette = m_effects.palette();
+    auto lerp = [t](float a, float b) { return a + (b - a) * t; };
+
+    if (m_backend == Backend::Particles) {
+        const float* x = m_system.x();
+        const float* y = m_system.y();
+        const float* px = m_system.prevX();
+        const float* py = m_system.prevY();
+        const float* half = m_system.half();
+        const float* angle = m_system.angle();
+        const float* pangle = m_system.prevAngle();
+        const std::uint8_t* color = m_system.color();
+        for (std::size_t i = 0; i < m_system.size(); ++i)
+            f(lerp(px[i], x[i]), lerp(py[i], y[i]), half[i], lerp(pangle[i], angle[i]),
+              palette[color[i]], m_system.alpha(i));
+        return;
+    }
+
+    for (auto const& p : m_parts) {
+        float age = m_simTime - p.birthTime;
+        float alpha = (age > p.life)
+                          ? qMax(0.0f, 1.0f - (age - p.life)/p.fade)
+                          : 1.0f;
+        b2Vec2 pos = p.body->GetPosition();
+        f(lerp(p.prevPos.x, pos.x), lerp(p.prevPos.y, pos.y), p.size,
+          lerp(p.prevAngle, p.body->GetAngle()), palette[p.color], alpha);
+    }
+}
 
-        float angle = std::uniform_real_distribution<float>(0, 2*b2_pi)(rng);
-        b2Vec2 impulse = 5.0f * b2Vec2(cosf(angle), sinf(angle));
-        b->ApplyLinearImpulse(impulse, b->GetWorldCenter(), true);
+bool ConfettiController::stepPhysics() {
+    if (particleCount() == 0 && m_running.empty()) {
+        // Erase whatever the last particles covered, then go quiet
+        if (!m_lastRegion.isEmpty()) {
+            board->scheduleRepaint(m_lastRegion);
+            m_lastRegion = QRegion();
+        }
+        m_lastStepNs = -1;
+        m_simTime = 0.0f;  // nothing alive refers to it
+        return false;
+    }
 
-        Particles p{ b, kPalette[colDist(rng)], half, now };
-        m_parts.push_back(p);
+    // Fixed steps for the time that really passed; after a stall only
+    // kMaxSubSteps are caught up and the rest is dropped
+    qint64 now = m_clock.nsecsElapsed();
+    m_accumulator += (now - m_lastStepNs) * 1e-9f;
+    m_lastStepNs = now;
+    m_accumulator = qMin(m_accumulator, kMaxSubSteps * kFixedStep);
+    while (m_accumulator >= kFixedStep) {
+        simulate(kFixedStep);
+        m_accumulator -= kFixedStep;
     }
+    m_blend = m_accumulator / kFixedStep;
+    cull();
+
+    // Repaint where particles are now and where they were last frame
+    QRegion region = particleRegion();
+    board->scheduleRepaint(region + m_lastRegion);
+    m_lastRegion = region;
+
+    // This frame's simulation plus the last paint against the budget
+    qint64 cost = m_clock.nsecsElapsed() - now + m_drawNs;
+    m_drawNs = 0;
+    m_governor.sample(cost * 1e-6);
+    return true;
 }
 
-void ConfettiController::stepPhysics() {
-    if (m_parts.empty()) return;
+void ConfettiController::setFrameBudget(double ms) {
+    m_governor.setBudget(ms);
+}
 
-    world.Step(1.0f/60.0f, 8, 3);
+void ConfettiController::stepBodies(float step) {
+    for (auto &p : m_parts) {
+        p.prevPos = p.body->GetPosition();
+        p.prevAngle = p.body->GetAngle();
+    }
+    world.Step(step, qMin(m_profile.velocityIterations, quality().velocityIterations),
+               qMin(m_profile.positionIterations, quality().positionIterations));
 
     const float worldW = 8.0f;
     for (auto &p : m_parts) {
@@ -108,39 +347,147 @@ void ConfettiController::stepPhysics() {
             b->SetLinearVelocity(vel);
         }
     }
+}
+
+void ConfettiController::simulate(float step) {
+    runEmitters(step);
+    if (m_backend == Backend::Particles) {
+        m_system.step(step);
+    } else {
+        stepBodies(step);
+    }
+    m_simTime += step;
+}
+
+void ConfettiController::cull() {
+    if (m_backend == Backend::Particles) {
+        m_system.removeExpired();
+        return;
+    }
+
+    // Swap-and-pop: each expiry is O(1) and the body is kept for reuse
+    for (std::size_t i = 0; i < m_parts.size(); ) {
+        const Particles& p = m_parts[i];
+        if (m_simTime - p.birthTime > p.life + p.fade)
+            releasePart(i);
+        else
+            ++i;
+    }
+}
 
-    float now = m_clock.elapsed() * 0.001f;
-    for (int i = int(m_parts.size())-1; i >= 0; --i) {
-        float age = now - m_parts[i].birthTime;
-        if (age > (kLifeSpan + kFadeDuration)) {
-            world.DestroyBody(m_parts[i].body);
-            m_parts.erase(m_parts.begin()+i);
+QRegion ConfettiController::particleRegion() const {
+    const QRect bounds = board->rect();
+    const int cols = (bounds.width() + kDirtyTile - 1) / kDirtyTile;
+    const int rows = (bounds.height() + kDirtyTile - 1) / kDirtyTile;
+    if (cols <= 0 || rows <= 0) return QRegion();
+
+    std::vector<char> tiles(cols * rows, 0);
+    // One metre is one board square
+    const float scale = board->squareSide();
+    forEachParticle([&](float x, float y, float half, float, const QColor&, float) {
+        QPointF centre = board->worldToWidget(x, y);
+        float px = float(centre.x());
+        float py = float(centre.y());
+        // Half-diagonal of the rotated square plus a pixel for antialiasing
+        float reach = half * scale * 1.4143f + 1.0f;
+
+        int c0 = qMax(0, int((px - reach) / kDirtyTile));
+        int c1 = qMin(cols - 1, int((px + reach) / kDirtyTile));
+        int r0 = qMax(0, int((py - reach) / kDirtyTile));
+        int r1 = qMin(rows - 1, int((py + reach) / kDirtyTile));
+        for (int r = r0; r <= r1; ++r)
+            for (int c = c0; c <= c1; ++c)
+                tiles[r * cols + c] = 1;
+    });
+
+    // Merge each row's tiles into horizontal runs
+    QRegion region;
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ) {
+            if (!tiles[r * cols + c]) { ++c; continue; }
+            int start = c;
+            while (c < cols && tiles[r * cols + c]) ++c;
+            region += QRect(start * kDirtyTile, r * kDirtyTile,
+                            (c - start) * kDirtyTile, kDirtyTile);
         }
     }
+    return region;
+}
 
-    board->update();
+void ConfettiController::collectQuads(std::vector<ConfettiQuad>& out) const {
+    out.clear();
+    out.reserve(particleCount());
+    const float scale = board->squareSide();
+    forEachParticle([&](float x, float y, float half, float angle, const QColor& color, float alpha) {
+        QPointF centre = board->worldToWidget(x, y);
+        out.push_back({ float(centre.x()),
+                        float(centre.y()),
+                        half * scale,
+                        angle,
+                        color,
+                        alpha });
+    });
 }
 
 void ConfettiController::draw(QPainter& painter) const {
-    float now = m_clock.elapsed() * 0.001f;
-    for (auto const& p : m_parts) {
-        float age = now - p.birthTime;
-        float alpha = (age > kLifeSpan)
-                          ? qMax(0.0f, 1.0f - (age - kLifeSpan)/kFadeDuration)
-                          : 1.0f;
-        painter.setOpacity(alpha);
+    QElapsedTimer timer;
+    timer.start();
+    std::vector<ConfettiQuad> quads;
+    collectQuads(quads);
+    if (quads.empty()) return;
+    const bool points = quality().points;
 
-        b2Vec2 pos = p.body->GetPosition();
-        float px = pos.x * kScale;
-        float py = (8.0f*kScale) - (pos.y*kScale);
-
-        painter.save();
-        painter.translate(px, py);
-        painter.rotate(p.body->GetAngle() * 180.0f / b2_pi);
-        float sidePx = p.size * 2 * kScale;
-        QRectF r(-sidePx/2, -sidePx/2, sidePx, sidePx);
-        painter.fillRect(r, p.color);
-        painter.restore();
-    }
-    painter.setOpacity(1.0f);
+    // One path (or point list) per colour and fade level; winding fill so
+    // overlapping squares in a path don't punch holes in each other
+    struct Bucket {
+        QRgb            rgb;
+        int             level;
+        QPainterPath    path;
+        QVector<QPointF> centres;
+        float           sides;  ///< Sum of side lengths, for the point size
+    };
+    std::vector<Bucket> buckets;
+    for (auto const& q : quads) {
+        int level = int(q.alpha * kAlphaLevels + 0.5f);
+        if (level <= 0) continue;
+
+        QRgb rgb = q.color.rgb();
+        auto it = std::find_if(buckets.begin(), buckets.end(), [&](const Bucket& b) {
+            return b.rgb == rgb && b.level == level;
+        });
+        if (it == buckets.end()) {
+            buckets.push_back({ rgb, level, QPainterPath(), QVector<QPointF>(), 0.0f });
+            it = buckets.end() - 1;
+            it->path.setFillRule(Qt::WindingFill);
+        }
+
+        if (points) {
+            it->centres.append(QPointF(q.x, q.y));
+            it->sides += 2.0f * q.half;
+            continue;
+        }
+
+        // Corners of the square rotated about its centre, as painter.rotate would
+        float c = std::cos(q.angle) * q.half;
+        float s = std::sin(q.angle) * q.half;
+        it->path.moveTo(q.x + c + s, q.y + s - c);
+        it->path.lineTo(q.x + c - s, q.y + s + c);
+        it->path.lineTo(q.x - c - s, q.y - s + c);
+        it->path.lineTo(q.x - c + s, q.y - s - c);
+        it->path.closeSubpath();
+    }
+
+    for (auto const& b : buckets) {
+        QColor color = QColor::fromRgb(b.rgb);
+        color.setAlphaF(float(b.level) / kAlphaLevels);
+        if (points) {
+            // Unrotated squares of the bucket's average size
+            QPen pen(color, qMax(1.0f, b.sides / b.centres.size()), Qt::SolidLine, Qt::SquareCap);
+            painter.setPen(pen);
+            painter.drawPoints(b.centres.constData(), int(b.centres.size()));
+        } else {
+            painter.fillPath(b.path, color);
+        }
+    }
+    m_drawNs = timer.nsecsElapsed();
 }
@@ -4,7 +4,8 @@
  * Defines the ConfettiController class, which manages confetti
  * particle simulation and rendering for both capture and puzzle
  * completion celebrations on the chess board.
- * Uses Box2D for realistic physics and QPainter for drawing.
+ * Uses Box2D for realistic physics, or the lighter ParticleSystem when
+ * selected, and QPainter for drawing.
  *
  * @author  ESL Team
  * @date    2025-04-22
@@ -14,18 +15,37 @@
 
 #include "qcolor.h"
 #include <QObject>
-#include <QTimer>
 #include <QElapsedTimer>
+#include <QRegion>
 #include <vector>
 #include <Box2D/Box2D.h>
+#include "effectlibrary.h"
+#include "particleemitter.h"
+#include "particlesystem.h"
+#include "qualitygovernor.h"
 
 class ChessBoard;
 class QPainter;
 
+/**
+ * ConfettiQuad
+ *
+ * One particle as it should appear on screen this frame, in widget pixels.
+ */
+struct ConfettiQuad {
+    float  x;      ///< Centre x
+    float  y;      ///< Centre y
+    float  half;   ///< Half the side length
+    float  angle;  ///< Rotation in radians, clockwise on screen
+    QColor color;  ///< Fill colour
+    float  alpha;  ///< Opacity from the fade-out
+};
+
 /**
  * ConfettiController
  *
  * Inherits QObject to provide timed physics updates and drawing hooks.
+ * Physics is stepped by the shared FrameClock only while particles exist.
  * - Simulates confetti particles using Box2D physics (gravity, bounces, damping).
  * - Renders particles as colored squares via QPainter on the ChessBoard.
  * - Supports random bursts or targeted spawns at specific board coordinates.
@@ -34,6 +54,32 @@ class ConfettiController : public QObject {
     Q_OBJECT
 
 public:
+    /// Simulation used for new confetti
+    enum class Backend {
+        Box2D,      ///< One Box2D body per particle; particles collide (default)
+        Particles   ///< ParticleSystem arrays; no collisions, far cheaper
+    };
+
+    /**
+     * PhysicsProfile
+     *
+     * How the Box2D backend simulates confetti. The defaults are cheapest:
+     * particles pass through each other, so their bodies need no fixtures
+     * at all, the broadphase stays empty and no contacts or
+     * time-of-impact solving ever happen.
+     */
+    struct PhysicsProfile {
+        bool  particleCollisions{false}; ///< Particles bounce off each other
+        bool  floor{false};              ///< Static ground along the bottom of the board
+        bool  bullets{false};            ///< Honour presets asking for continuous collision
+        bool  allowSleep{true};          ///< Resting bodies stop being simulated
+        float linearSleepTolerance{b2_linearSleepTolerance};   ///< Metres per second
+        float angularSleepTolerance{b2_angularSleepTolerance}; ///< Radians per second
+        float timeToSleep{b2_timeToSleep};                     ///< Seconds at rest
+        int   velocityIterations{8};     ///< Solver iterations at full quality
+        int   positionIterations{3};
+    };
+
     /**
      * Constructor
      *
@@ -52,7 +98,8 @@ public:
     /**
      * spawn
      *
-     * Create a burst of confetti particles from the top of the board.
+     * Create a burst of confetti particles from the top of the board
+     * (the "solve" effect).
      *
      * @param count Number of particles to spawn.
      */
@@ -62,24 +109,174 @@ public:
      * spawnAt
      *
      * Create a burst of confetti particles at a specific world coordinate
-     * and apply random impulses.
+     * and apply random impulses (the "capture" effect).
      *
      * @param worldPos 2D position in Box2D world units (meters).
      * @param count    Number of particles to spawn (default: 100).
      */
     void spawnAt(const b2Vec2& worldPos, int count = 100);
 
+    /**
+     * play
+     *
+     * Start a named effect from the effect library. Effects with a rate
+     * keep emitting for their duration. All effects share one simulation
+     * and the capacity() budget; particles past it are not created.
+     *
+     * @param name  Effect name, e.g. "capture" or "solve".
+     * @param at    Trigger point in world units.
+     * @param count Particles for the initial burst, or -1 for the preset's count.
+     * @return False if no effect has that name.
+     */
+    bool play(const QString& name, const b2Vec2& at, int count = -1);
+
+    /**
+     * celebrate
+     *
+     * Play a named effect from the top centre of the board, as for a
+     * solved puzzle ("solve") or a won game ("win").
+     *
+     * @param name Effect name.
+     * @return False if no effect has that name.
+     */
+    bool celebrate(const QString& name) { return play(name, b2Vec2(4.0f, 12.0f)); }
+
+    /**
+     * effects
+     *
+     * Library play() looks effects up in; load more JSON into it to add
+     * or replace effects. The built-in ones come from Assets/effects.json.
+     */
+    EffectLibrary& effects() { return m_effects; }
+
+    /**
+     * simulate
+     *
+     * Advance running effects and the active backend by one step without
+     * culling or repainting. The frame clock drives this through
+     * stepPhysics; benchmarks call it directly.
+     *
+     * @param step Step length in seconds.
+     */
+    void simulate(float step);
+
+    /**
+     * cull
+     *
+     * Drop particles whose fade-out has ended.
+     */
+    void cull();
+
     /**
      * draw
      *
      * Render all active confetti particles as fading, rotating squares.
+     * Squares are grouped by colour and fade step and each group is filled
+     * as one path, so painter state changes per group, not per particle.
      *
      * @param painter QPainter reference used for drawing onto ChessBoard.
      */
     void draw(QPainter& painter) const;
 
-    /// Pixel scaling factor: Box2D meters to screen pixels
-    static constexpr float kScale = 50.0f;
+    /**
+     * collectQuads
+     *
+     * Screen-space description of every live particle, for renderers that
+     * do not draw through QPainter.
+     *
+     * @param out Cleared and filled with one quad per particle.
+     */
+    void collectQuads(std::vector<ConfettiQuad>& out) const;
+
+    /**
+     * setBackend
+     *
+     * Choose the simulation for confetti. Particles already in flight are
+     * dropped when the backend changes.
+     *
+     * @param backend Simulation to use.
+     */
+    void setBackend(Backend backend);
+
+    /**
+     * backend
+     *
+     * @return Simulation in use.
+     */
+    Backend backend() const { return m_backend; }
+
+    /**
+     * particleCount
+     *
+     * @return Live particles in the active backend.
+     */
+    std::size_t particleCount() const;
+
+    /**
+     * setCapacity
+     *
+     * Cap the number of live particles; spawns past the cap are dropped.
+     * Box2D bodies of expired particles are parked and reused up to this
+     * many, so bursts neither allocate nor destroy bodies once warm.
+     *
+     * @param capacity Maximum live particles.
+     */
+    void setCapacity(std::size_t capacity);
+
+    /**
+     * capacity
+     *
+     * @return Maximum live particles.
+     */
+    std::size_t capacity() const { return m_capacity; }
+
+    /**
+     * setPhysicsProfile
+     *
+     * Change how Box2D confetti is simulated. Particles already in flight
+     * keep their shape but take on the new collision filter and bullet
+     * setting; parked bodies are discarded.
+     *
+     * @param profile New settings.
+     */
+    void setPhysicsProfile(const PhysicsProfile& profile);
+
+    /**
+     * physicsProfile
+     *
+     * @return Settings of the Box2D backend.
+     */
+    const PhysicsProfile& physicsProfile() const { return m_profile; }
+
+    /**
+     * setFrameBudget
+     *
+     * Time per frame confetti may take for stepping and drawing before its
+     * quality is lowered: fewer particles per effect, fewer Box2D solver
+     * iterations, then points instead of rotated squares. Quality comes
+     * back once frames are well under budget again. Default 4 ms.
+     *
+     * @param ms Budget in milliseconds; 0 keeps full quality always.
+     */
+    void setFrameBudget(double ms);
+
+    /**
+     * qualityLevel
+     *
+     * @return 0 for full quality, up to kQualityLevels - 1.
+     */
+    int qualityLevel() const { return m_governor.level(); }
+
+    /**
+     * seed
+     *
+     * Restart the spawn generator from a fixed value so bursts repeat
+     * exactly, e.g. in tests. It is seeded from std::random_device once
+     * at construction otherwise.
+     *
+     * @param seed Generator seed.
+     */
+    void seed(std::uint64_t seed) { m_emitter.seed(seed); }
 
 signals:
     /**
@@ -95,29 +292,181 @@ private:
     /**
      * stepPhysics
      *
-     * Advance the Box2D simulation, handle wall bounces, and cull expired particles.
+     * Advance the active backend in fixed kFixedStep steps for the time
+     * measured on m_clock since the last frame, then repaint where the
+     * particles moved. Drawing interpolates between the last two steps.
+     *
+     * @return True while particles remain and the clock should keep ticking.
+     */
+    bool stepPhysics();
+
+    /**
+     * stepBodies
+     *
+     * Box2D backend: step the world and bounce off the side walls.
+     *
+     * @param step Step length in seconds.
      */
-    void stepPhysics();
+    void stepBodies(float step);
+
+    /**
+     * wake
+     *
+     * Register with the frame clock after a spawn; it stops on its own when
+     * the last particle is gone.
+     */
+    void wake();
+
+    /**
+     * particleRegion
+     *
+     * Screen area covered by the particles, snapped to kDirtyTile tiles so
+     * the region stays a handful of rectangles however many particles exist.
+     *
+     * @return Area to repaint for the current particle positions.
+     */
+    QRegion particleRegion() const;
+
+    /**
+     * emitPreset
+     *
+     * Generate and launch up to count particles of a preset, fewer if the
+     * capacity budget is nearly used up.
+     */
+    void emitPreset(const EmitterPreset& preset, const b2Vec2& at, int count);
+
+    /**
+     * runEmitters
+     *
+     * Emit the rate-driven particles of running effects for one step and
+     * drop effects whose duration is over.
+     */
+    void runEmitters(float step);
+
+    /// What each quality level does
+    struct Quality {
+        float spawnScale;          ///< Fraction of each effect's particles spawned
+        bool  points;              ///< Draw unrotated points instead of squares
+        int   velocityIterations;  ///< Cap on Box2D solver iterations
+        int   positionIterations;
+    };
+
+    /// Settings of the current quality level
+    const Quality& quality() const { return kQuality[m_governor.level()]; }
+
+    /**
+     * launch
+     *
+     * Create one particle in the active backend.
+     */
+    void launch(const ParticleSpawn& spawn);
+
+    /**
+     * acquireBody
+     *
+     * Box2D backend: reuse a parked body for the spawn, or create one if
+     * none is free.
+     */
+    b2Body* acquireBody(const ParticleSpawn& spawn);
+
+    /**
+     * needsFixtures
+     *
+     * @return True if the profile has anything for particles to touch.
+     */
+    bool needsFixtures() const { return m_profile.particleCollisions || m_profile.floor; }
+
+    /**
+     * particleFilter
+     *
+     * @return Collision filter for particle fixtures under the profile.
+     */
+    b2Filter particleFilter() const;
+
+    /**
+     * releasePart
+     *
+     * Box2D backend: park the body of m_parts[i] for reuse and fill its
+     * slot with the last particle.
+     */
+    void releasePart(std::size_t i);
+
+    /**
+     * forEachParticle
+     *
+     * Call f(x, y, half, angle, color, alpha) for every live particle of
+     * either backend, in world units.
+     */
+    template <typename F>
+    void forEachParticle(F&& f) const;
 
     struct Particles {
         b2Body*  body;       ///< Box2D body representing the particle
-        QColor   color;      ///< Render color
+        std::uint8_t color;  ///< Palette index
         float    size;       ///< Half-size (meters)
-        float    birthTime;  ///< Timestamp of creation (seconds)
+        float    birthTime;  ///< m_simTime at creation (seconds)
+        float    life;       ///< Seconds at full opacity
+        float    fade;       ///< Seconds fading out after life
+        b2Vec2   prevPos;    ///< Position before the last step
+        float    prevAngle;  ///< Angle before the last step
+    };
+
+    /// An effect still emitting at its rate
+    struct Running {
+        EmitterPreset        preset;    ///< Copy, so reloading effects is safe
+        b2Vec2               at;        ///< Trigger point
+        float                remaining; ///< Seconds left to emit
+        float                carry;     ///< Fraction of a particle owed
     };
 
     b2World                world;   ///< Physics world with gravity
-    QTimer                 timer;   ///< Periodic update timer (60Hz)
-    QElapsedTimer          m_clock; ///< Exact elapsed time for lifetimes
+    QElapsedTimer          m_clock; ///< Real time that drives the fixed steps
     ChessBoard*            board;   ///< Target chess board for redraws
-    std::vector<Particles> m_parts; ///< Active confetti particles
+    std::vector<Particles> m_parts; ///< Active Box2D confetti particles, unordered
+    std::vector<b2Body*>   m_spare; ///< Inactive bodies waiting to be reused
+    ParticleSystem         m_system;///< Active confetti for the Particles backend
+    EffectLibrary          m_effects;    ///< Named effects and the particle palette
+    ParticleEmitter        m_emitter;    ///< Random spawn generator, seeded once
+    std::vector<Running>   m_running;    ///< Effects emitting over time
+    std::vector<ParticleSpawn> m_batch;  ///< Spawns of the burst being launched
+    Backend                m_backend{Backend::Box2D}; ///< Simulation for new confetti
+    QRegion                m_lastRegion; ///< Area painted last frame, to erase
+    std::size_t            m_capacity{kDefaultCapacity}; ///< Live particle cap
+    qint64                 m_lastStepNs{-1};   ///< m_clock time of the last frame; -1 while idle
+    float                  m_accumulator{0};   ///< Simulated time owed, below one step
+    float                  m_blend{0};         ///< Draw position between the last two steps, 0..1
+    float                  m_simTime{0};       ///< Simulated seconds, for Box2D particle lifetimes
+    QualityGovernor        m_governor;         ///< Lowers quality when frames run over budget
+    PhysicsProfile         m_profile;          ///< Box2D settings
+    b2Body*                m_floor{nullptr};   ///< Ground body while the profile has one
+    mutable qint64         m_drawNs{0};        ///< Cost of the last draw(), for the governor
+
+    /// Live particle cap unless setCapacity says otherwise
+    static constexpr std::size_t kDefaultCapacity = 2000;
+
+    /// Collision categories: the floor, and particles
+    static constexpr uint16 kWorldCategory = 0x0001;
+    static constexpr uint16 kParticleCategory = 0x0002;
+
+    /// Quality levels, full first
+    static constexpr int kQualityLevels = 4;
+    static const Quality kQuality[kQualityLevels];
+
+    /// Frame budget in milliseconds unless setFrameBudget says otherwise
+    static constexpr double kDefaultBudgetMs = 4.0;
+
+    /// Physics step length in seconds, whatever the display rate
+    static constexpr float kFixedStep = 1.0f / 60.0f;
+
+    /// Most physics steps run for one frame
+    static constexpr int kMaxSubSteps = 4;
+
+    /// Fade steps drawn; particles of one colour and step share a fill
+    static constexpr int kAlphaLevels = 16;
 
-    // Lifespan parameters (seconds)
-    static constexpr float kLifeSpan     = 3.0f;
-    static constexpr float kFadeDuration = 1.0f;
+    /// Side of a dirty-tracking tile in pixels
+    static constexpr int kDirtyTile = 25;
 
-    /// Color palette for particles
-    static const std::vector<QColor> kPalette;
 
 public slots:
     /**
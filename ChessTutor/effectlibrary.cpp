@@ -0,0 +1,95 @@
+#include "effectlibrary.h"
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+namespace {
+
+FloatRange readRange(const QJsonValue& v, FloatRange fallback) {
+    if (v.isDouble())
+        return { float(v.toDouble()), float(v.toDouble()) };
+    if (v.isArray() && v.toArray().size() == 2) {
+        QJsonArray a = v.toArray();
+        return { float(a[0].toDouble()), float(a[1].toDouble()) };
+    }
+    return fallback;
+}
+
+float readFloat(const QJsonObject& o, const char* key, float fallback) {
+    return float(o.value(QLatin1String(key)).toDouble(fallback));
+}
+
+} // namespace
+
+bool EffectLibrary::load(const QString& path, QString* error) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+    return loadJson(file.readAll(), error);
+}
+
+bool EffectLibrary::loadJson(const QByteArray& json, QString* error) {
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(json, &parseError);
+    if (!doc.isObject()) {
+        if (error) *error = parseError.errorString();
+        return false;
+    }
+
+    QJsonObject effects = doc.object().value("effects").toObject();
+    for (auto it = effects.begin(); it != effects.end(); ++it) {
+        QJsonObject o = it.value().toObject();
+        EmitterPreset p;
+
+        QString shape = o.value("shape").toString("point");
+        if (shape == "line")      p.shape = EmitterPreset::Shape::Line;
+        else if (shape == "ring") p.shape = EmitterPreset::Shape::Ring;
+
+        p.extent = readFloat(o, "extent", p.extent);
+        p.count = o.value("count").toInt(p.count);
+        p.rate = readFloat(o, "rate", p.rate);
+        p.duration = readFloat(o, "duration", p.duration);
+        p.life = readFloat(o, "life", p.life);
+        p.fade = qMax(0.001f, readFloat(o, "fade", p.fade));
+        p.size = readRange(o.value("size"), p.size);
+        p.velocityX = readRange(o.value("velocityX"), p.velocityX);
+        p.velocityY = readRange(o.value("velocityY"), p.velocityY);
+        p.impulse = readRange(o.value("impulse"), p.impulse);
+        p.spin = readRange(o.value("spin"), p.spin);
+        p.restitution = readRange(o.value("restitution"), p.restitution);
+        p.friction = readFloat(o, "friction", p.friction);
+        p.bullet = o.value("bullet").toBool(p.bullet);
+        p.linearDamping = readFloat(o, "linearDamping", p.linearDamping);
+        p.angularDamping = readFloat(o, "angularDamping", p.angularDamping);
+        p.gravityScale = readFloat(o, "gravityScale", p.gravityScale);
+
+        for (const QJsonValue& c : o.value("palette").toArray()) {
+            QColor color(c.toString());
+            if (color.isValid())
+                p.colors.push_back(colorIndex(color));
+        }
+        if (p.colors.empty())
+            p.colors.push_back(colorIndex(Qt::white));
+
+        presets.insert(it.key(), p);
+    }
+    return true;
+}
+
+const EmitterPreset* EffectLibrary::find(const QString& name) const {
+    auto it = presets.constFind(name);
+    return it == presets.constEnd() ? nullptr : &it.value();
+}
+
+std::uint8_t EffectLibrary::colorIndex(const QColor& color) {
+    for (std::size_t i = 0; i < colors.size(); ++i)
+        if (colors[i].rgb() == color.rgb())
+            return std::uint8_t(i);
+    if (colors.size() >= 256)
+        return 0;
+    colors.push_back(color);
+    return std::uint8_t(colors.size() - 1);
+}
@@ -0,0 +1,81 @@
+/*
+ * effectlibrary.h
+ *
+ * Defines the EffectLibrary class, the named particle effects the board
+ * can play (captures, solved puzzles, won games, ...). Effects are
+ * emitter presets read from JSON, so new ones need no code, only a name
+ * to trigger them by.
+ *
+ * @author  ESL Team
+ * @date    2026-10-16
+ */
+#ifndef EFFECTLIBRARY_H
+#define EFFECTLIBRARY_H
+
+#include <QColor>
+#include <QHash>
+#include <QString>
+#include <vector>
+#include "particleemitter.h"
+
+/**
+ * EffectLibrary
+ *
+ * Named EmitterPresets plus the colour palette their particles index.
+ *
+ * The JSON holds an "effects" object of presets by name:
+ *
+ *   { "effects": { "capture": { "shape": "point", "count": 30,
+ *                               "impulse": 5, "size": [0.03, 0.08],
+ *                               "palette": ["#0079FF", "#FF0060"] } } }
+ *
+ * Ranges are [min, max] or a single number. Keys: shape (point, line,
+ * ring), extent, count, rate, duration, life, fade, size, velocityX,
+ * velocityY, impulse, spin, restitution, friction, bullet, linearDamping,
+ * angularDamping, gravityScale, palette. Missing keys keep their defaults.
+ */
+class EffectLibrary {
+public:
+    /**
+     * load
+     *
+     * Read presets from a JSON file. Presets with a name already loaded
+     * replace the old ones.
+     *
+     * @param path  File or resource path.
+     * @param error Receives a description when loading fails.
+     * @return True if the file was read and parsed.
+     */
+    bool load(const QString& path, QString* error = nullptr);
+
+    /**
+     * loadJson
+     *
+     * Same as load() for JSON already in memory.
+     */
+    bool loadJson(const QByteArray& json, QString* error = nullptr);
+
+    /**
+     * find
+     *
+     * @param name Effect name.
+     * @return The preset, or nullptr if there is none by that name.
+     */
+    const EmitterPreset* find(const QString& name) const;
+
+    /**
+     * palette
+     *
+     * @return Colours indexed by ParticleSpawn::color.
+     */
+    const std::vector<QColor>& palette() const { return colors; }
+
+private:
+    /// Palette index of a colour, added if new; the palette holds 256 at most
+    std::uint8_t colorIndex(const QColor& color);
+
+    QHash<QString, EmitterPreset> presets; ///< Effects by name
+    std::vector<QColor>           colors;  ///< Shared particle palette
+};
+
+#endif // EFFECTLIBRARY_H
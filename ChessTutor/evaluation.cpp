@@ -0,0 +1,190 @@
+#include "evaluation.h"
+#include "chess.h"
+#include <cstdlib>
+
+// Piece values indexed by piece code (PAWN, ROOK, KNIGHT, BISHOP, QUEEN, KING)
+static const int kMaterialMg[7]{0, 82, 477, 337, 365, 1025, 0};
+static const int kMaterialEg[7]{0, 94, 512, 281, 297, 936, 0};
+static const int kPhaseWeight[7]{0, 0, 2, 1, 1, 4, 0};
+
+// Piece-square tables from White's point of view, laid out like the board:
+// row 0 is rank 8, so a black piece on (row, col) reads entry (7 - row, col).
+static const int kPawnMg[64]{
+     0,  0,  0,  0,  0,  0,  0,  0,
+    50, 50, 50, 50, 50, 50, 50, 50,
+    10, 10, 20, 30, 30, 20, 10, 10,
+     5,  5, 10, 25, 25, 10,  5,  5,
+     0,  0,  0, 20, 20,  0,  0,  0,
+     5, -5,-10,  0,  0,-10, -5,  5,
+     5, 10, 10,-20,-20, 10, 10,  5,
+     0,  0,  0,  0,  0,  0,  0,  0
+};
+static const int kPawnEg[64]{
+     0,  0,  0,  0,  0,  0,  0,  0,
+    80, 80, 80, 80, 80, 80, 80, 80,
+    50, 50, 50, 50, 50, 50, 50, 50,
+    30, 30, 30, 30, 30, 30, 30, 30,
+    15, 15, 15, 15, 15, 15, 15, 15,
+     5,  5,  5,  5,  5,  5,  5,  5,
+     0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0
+};
+static const int kKnight[64]{
+   -50,-40,-30,-30,-30,-30,-40,-50,
+   -40,-20,  0,  0,  0,  0,-20,-40,
+   -30,  0, 10, 15, 15, 10,  0,-30,
+   -30,  5, 15, 20, 20, 15,  5,-30,
+   -30,  0, 15, 20, 20, 15,  0,-30,
+   -30,  5, 10, 15, 15, 10,  5,-30,
+   -40,-20,  0,  5,  5,  0,-20,-40,
+   -50,-40,-30,-30,-30,-30,-40,-50
+};
+static const int kBishop[64]{
+   -20,-10,-10,-10,-10,-10,-10,-20,
+   -10,  0,  0,  0,  0,  0,  0,-10,
+   -10,  0,  5, 10, 10,  5,  0,-10,
+   -10,  5,  5, 10, 10,  5,  5,-10,
+   -10,  0, 10, 10, 10, 10,  0,-10,
+   -10, 10, 10, 10, 10, 10, 10,-10,
+   -10,  5,  0,  0,  0,  0,  5,-10,
+   -20,-10,-10,-10,-10,-10,-10,-20
+};
+static const int kRook[64]{
+     0,  0,  0,  0,  0,  0,  0,  0,
+     5, 10, 10, 10, 10, 10, 10,  5,
+    -5,  0,  0,  0,  0,  0,  0, -5,
+    -5,  0,  0,  0,  0,  0,  0, -5,
+    -5,  0,  0,  0,  0,  0,  0, -5,
+    -5,  0,  0,  0,  0,  0,  0, -5,
+    -5,  0,  0,  0,  0,  0,  0, -5,
+     0,  0,  0,  5,  5,  0,  0,  0
+};
+static const int kQueen[64]{
+   -20,-10,-10, -5, -5,-10,-10,-20,
+   -10,  0,  0,  0,  0,  0,  0,-10,
+   -10,  0,  5,  5,  5,  5,  0,-10,
+    -5,  0,  5,  5,  5,  5,  0, -5,
+     0,  0,  5,  5,  5,  5,  0, -5,
+   -10,  5,  5,  5,  5,  5,  0,-10,
+   -10,  0,  5,  0,  0,  0,  0,-10,
+   -20,-10,-10, -5, -5,-10,-10,-20
+};
+static const int kKingMg[64]{
+   -30,-40,-40,-50,-50,-40,-40,-30,
+   -30,-40,-40,-50,-50,-40,-40,-30,
+   -30,-40,-40,-50,-50,-40,-40,-30,
+   -30,-40,-40,-50,-50,-40,-40,-30,
+   -20,-30,-30,-40,-40,-30,-30,-20,
+   -10,-20,-20,-20,-20,-20,-20,-10,
+    20, 20,  0,  0,  0,  0, 20, 20,
+    20, 30, 10,  0,  0, 10, 30, 20
+};
+static const int kKingEg[64]{
+   -50,-40,-30,-20,-20,-30,-40,-50,
+   -30,-20,-10,  0,  0,-10,-20,-30,
+   -30,-10, 20, 30, 30, 20,-10,-30,
+   -30,-10, 30, 40, 40, 30,-10,-30,
+   -30,-10, 30, 40, 40, 30,-10,-30,
+   -30,-10, 20, 30, 30, 20,-10,-30,
+   -30,-30,  0,  0,  0,  0,-30,-30,
+   -50,-30,-30,-30,-30,-30,-30,-50
+};
+
+static const int* const kTableMg[7]{nullptr, kPawnMg, kRook, kKnight, kBishop, kQueen, kKingMg};
+static const int* const kTableEg[7]{nullptr, kPawnEg, kRook, kKnight, kBishop, kQueen, kKingEg};
+
+// Mobility weight per reachable square, and the square count treated as neutral
+static const int kMobilityMg[7]{0, 0, 2, 4, 5, 1, 0};
+static const int kMobilityEg[7]{0, 0, 4, 4, 5, 2, 0};
+static const int kMobilityBase[7]{0, 0, 7, 4, 7, 14, 0};
+
+void EvalAccumulator::reset(){
+    material = Score{};
+    pieceSquare = Score{};
+    phase = 0;
+}
+
+void EvalAccumulator::add(int piece, int row, int col){
+    if (piece == 0) return;
+    int type = abs(piece);
+    int sign = piece > 0 ? 1 : -1;
+    int index = (piece > 0 ? row : 7 - row) * 8 + col;
+
+    material.mg += sign * kMaterialMg[type];
+    material.eg += sign * kMaterialEg[type];
+    pieceSquare.mg += sign * kTableMg[type][index];
+    pieceSquare.eg += sign * kTableEg[type][index];
+    phase += kPhaseWeight[type];
+}
+
+void EvalAccumulator::remove(int piece, int row, int col){
+    if (piece == 0) return;
+    int type = abs(piece);
+    int sign = piece > 0 ? 1 : -1;
+    int index = (piece > 0 ? row : 7 - row) * 8 + col;
+
+    material.mg -= sign * kMaterialMg[type];
+    material.eg -= sign * kMaterialEg[type];
+    pieceSquare.mg -= sign * kTableMg[type][index];
+    pieceSquare.eg -= sign * kTableEg[type][index];
+    phase -= kPhaseWeight[type];
+}
+
+static int slideCount(const int board[8][8], int row, int col, int dRow, int dCol, int sign){
+    int n = 0;
+    int r = row + dRow;
+    int c = col + dCol;
+    while (r >= 0 && r < 8 && c >= 0 && c < 8){
+        if (board[r][c] * sign > 0) break;  // own piece blocks
+        n++;
+        if (board[r][c] != 0) break;         // capture ends the ray
+        r += dRow;
+        c += dCol;
+    }
+    return n;
+}
+
+Score evaluateMobility(const int board[8][8]){
+    static const int knightRow[8]{-2, -2, -1, -1, 1, 1, 2, 2};
+    static const int knightCol[8]{1, -1, 2, -2, -2, 2, 1, -1};
+    static const int dirRow[8]{-1, 1, 0, 0, -1, -1, 1, 1};
+    static const int dirCol[8]{0, 0, -1, 1, -1, 1, -1, 1};
+
+    Score score;
+    for (int row = 0; row < 8; row++){
+        for (int col = 0; col < 8; col++){
+            int piece = board[row][col];
+            int type = abs(piece);
+            if (type != KNIGHT && type != BISHOP && type != ROOK && type != QUEEN) continue;
+
+            int sign = piece > 0 ? 1 : -1;
+            int squares = 0;
+            if (type == KNIGHT){
+                for (int i = 0; i < 8; i++){
+                    int r = row + knightRow[i];
+                    int c = col + knightCol[i];
+                    if (r >= 0 && r < 8 && c >= 0 && c < 8 && board[r][c] * sign <= 0) squares++;
+                }
+            }
+            else{
+                // Rook rays are directions 0-3, bishop rays 4-7
+                int first = type == BISHOP ? 4 : 0;
+                int last = type == ROOK ? 4 : 8;
+                for (int i = first; i < last; i++){
+                    squares += slideCount(board, row, col, dirRow[i], dirCol[i], sign);
+                }
+            }
+
+            int delta = squares - kMobilityBase[type];
+            score.mg += sign * delta * kMobilityMg[type];
+            score.eg += sign * delta * kMobilityEg[type];
+        }
+    }
+    return score;
+}
+
+int taper(const Score& score, int phase){
+    if (phase > kMaxPhase) phase = kMaxPhase;
+    if (phase < 0) phase = 0;
+    return (score.mg * phase + score.eg * (kMaxPhase - phase)) / kMaxPhase;
+}
@@ -0,0 +1,115 @@
+/*
+ * evaluation.h
+ *
+ * Defines the static evaluation used to assess Chess positions: tapered
+ * (midgame/endgame) material and piece-square scores that are kept up to
+ * date incrementally as pieces move, plus a mobility term computed on
+ * demand from the board. Pawn structure lives in pawnhash.h.
+ *
+ * All scores are in centipawns from White's point of view.
+ *
+ * @author  ESL Team
+ * @date    2026-10-16
+ */
+#ifndef EVALUATION_H
+#define EVALUATION_H
+
+/**
+ * Score
+ *
+ * A midgame/endgame score pair. Blended by game phase at the end of
+ * evaluation so that terms can weigh differently as material comes off.
+ */
+struct Score{
+    int mg{0}; ///< Midgame component
+    int eg{0}; ///< Endgame component
+
+    Score& operator+=(const Score& other){ mg += other.mg; eg += other.eg; return *this; }
+    Score& operator-=(const Score& other){ mg -= other.mg; eg -= other.eg; return *this; }
+};
+
+/**
+ * EvalBreakdown
+ *
+ * Per-term result of an evaluation, each term already tapered by phase.
+ * Intended for the tutor UI to explain why a position is good or bad.
+ */
+struct EvalBreakdown{
+    int material{0};      ///< Material balance
+    int pieceSquare{0};   ///< Piece placement (piece-square tables)
+    int pawnStructure{0}; ///< Passed, isolated, doubled and backward pawns
+    int mobility{0};      ///< Reachable squares for minor and major pieces
+    int tablebase{0};     ///< Known result from endgame tablebases (0 if not probed)
+    bool fromTablebase{false}; ///< True when the tablebase term decided the total
+    int phase{0};         ///< Game phase, 0 (pawn ending) to kMaxPhase (opening)
+    int total{0};         ///< Sum of all terms
+};
+
+/**
+ * EvalAccumulator
+ *
+ * Running material and piece-square totals for a board. Chess feeds every
+ * piece placement and removal through add/remove so that the expensive
+ * part of the evaluation never needs a full board scan.
+ */
+class EvalAccumulator{
+public:
+    /**
+     * reset
+     *
+     * Zero every total, as for an empty board.
+     */
+    void reset();
+
+    /**
+     * add
+     *
+     * Account for a piece placed on a square.
+     * @param piece Signed piece code (positive white, negative black, 0 ignored)
+     * @param row   Row index (0-7)
+     * @param col   Column index (0-7)
+     */
+    void add(int piece, int row, int col);
+
+    /**
+     * remove
+     *
+     * Account for a piece lifted off a square.
+     * @param piece Signed piece code (positive white, negative black, 0 ignored)
+     * @param row   Row index (0-7)
+     * @param col   Column index (0-7)
+     */
+    void remove(int piece, int row, int col);
+
+    Score material;    ///< Material balance, white minus black
+    Score pieceSquare; ///< Piece-square balance, white minus black
+    int   phase{0};    ///< Unclamped game phase from non-pawn material
+};
+
+/// Phase value of the starting position; larger phases clamp to this.
+constexpr int kMaxPhase = 24;
+
+/// Score given to a tablebase win, well above any material balance.
+constexpr int kTablebaseWin = 20000;
+
+/**
+ * evaluateMobility
+ *
+ * Score the number of pseudo-legal destination squares of knights,
+ * bishops, rooks and queens for both sides.
+ * @param board 8×8 board of piece codes
+ * @return White-minus-black mobility score
+ */
+Score evaluateMobility(const int board[8][8]);
+
+/**
+ * taper
+ *
+ * Blend a midgame/endgame pair by game phase.
+ * @param score Score pair to blend
+ * @param phase Game phase (clamped to 0..kMaxPhase)
+ * @return Blended centipawn value
+ */
+int taper(const Score& score, int phase);
+
+#endif // EVALUATION_H
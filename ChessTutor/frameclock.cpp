@@ -0,0 +1,208 @@
+#include "frameclock.h"
+#include <QEvent>
+#include <QGuiApplication>
+#include <QOpenGLWidget>
+#include <QScreen>
+#include <QWindow>
+#include <algorithm>
+
+namespace {
+
+// Frame interval for a screen in ns, kept exact so deadlines don't drift
+qint64 intervalFor(const QScreen* screen, qint64 fallback) {
+    if (!screen) return fallback;
+    qreal hz = screen->refreshRate();
+    if (hz < 24.0) return fallback;
+    return qint64(1e9 / hz + 0.5);
+}
+
+// Timer delay in whole ms that does not wake up before the deadline
+int delayUntil(qint64 deadlineNs, qint64 nowNs) {
+    return int(qMax<qint64>(0, (deadlineNs - nowNs + 999999) / 1000000));
+}
+
+}
+
+FrameClock::FrameClock(QObject* parent)
+    : QObject(parent),
+    timer(this)
+{
+    clock.start();
+    timer.setSingleShot(true);
+    timer.setTimerType(Qt::PreciseTimer);
+    connect(&timer, &QTimer::timeout, this, &FrameClock::onTimer);
+
+    intervalNs = intervalFor(QGuiApplication::primaryScreen(), intervalNs);
+}
+
+FrameClock& FrameClock::shared() {
+    static FrameClock clock;
+    return clock;
+}
+
+void FrameClock::animate(QObject* owner, Tick tick) {
+    for (auto& a : animations) {
+        if (a.owner == owner) {
+            a.tick = std::move(tick);
+            return;
+        }
+    }
+    animations.push_back({ owner, std::move(tick) });
+    if (!ticking) rearm();
+}
+
+void FrameClock::cancel(QObject* owner) {
+    for (auto& a : animations) {
+        if (a.owner == owner) a.tick = nullptr;
+    }
+    if (!ticking) {
+        animations.erase(std::remove_if(animations.begin(), animations.end(),
+                                        [](const Animation& a) { return !a.tick; }),
+                         animations.end());
+        rearm();
+    }
+}
+
+void FrameClock::schedule(int delayMs, QObject* context, std::function<void()> action) {
+    pending.push_back({ now() + qMax(0, delayMs), context, std::move(action) });
+    if (!ticking) rearm();
+}
+
+void FrameClock::setFrameSource(QWindow* window) {
+    if (window == sourceWindow && !sourceView) return;
+    clearFrameSource();
+    sourceWindow = window;
+    if (window) {
+        window->installEventFilter(this);
+        intervalNs = intervalFor(window->screen(), intervalNs);
+    }
+    if (!ticking) rearm();
+}
+
+void FrameClock::setFrameSource(QOpenGLWidget* view) {
+    if (view == sourceView && !sourceWindow) return;
+    clearFrameSource();
+    sourceView = view;
+    if (view) {
+        swapConnection = connect(view, &QOpenGLWidget::frameSwapped,
+                                 this, &FrameClock::onPresented);
+        if (QWindow* window = view->window()->windowHandle())
+            intervalNs = intervalFor(window->screen(), intervalNs);
+    }
+    if (!ticking) rearm();
+}
+
+void FrameClock::clearFrameSource() {
+    if (sourceWindow) sourceWindow->removeEventFilter(this);
+    disconnect(swapConnection);
+    sourceWindow = nullptr;
+    sourceView = nullptr;
+    framePending = false;
+}
+
+bool FrameClock::eventFilter(QObject* watched, QEvent* event) {
+    // Run the frame before the window handles the request and paints, so
+    // this frame's repaints go out with it.
+    if (event->type() == QEvent::UpdateRequest && watched == sourceWindow)
+        onPresented();
+    return QObject::eventFilter(watched, event);
+}
+
+void FrameClock::onPresented() {
+    if (!framePending || ticking) return;
+    // Presentation faster than the refresh (no vsync): wait for the deadline
+    qint64 t = clock.nsecsElapsed();
+    if (t < nextFrame - intervalNs / 2) {
+        timer.start(delayUntil(nextFrame, t));
+        return;
+    }
+    runFrame();
+}
+
+void FrameClock::onTimer() {
+    runFrame();
+}
+
+void FrameClock::runFrame() {
+    ticking = true;
+    framePending = false;
+    qint64 t = now();
+    qint64 tNs = clock.nsecsElapsed();
+
+    // Delayed actions first, so a move they make is animated this frame.
+    // Actions may schedule more, so take the due ones out before running.
+    std::vector<Pending> due;
+    for (auto it = pending.begin(); it != pending.end(); ) {
+        if (it->due <= t) {
+            due.push_back(std::move(*it));
+            it = pending.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    std::sort(due.begin(), due.end(),
+              [](const Pending& a, const Pending& b) { return a.due < b.due; });
+    for (auto& p : due) {
+        if (p.context) p.action();
+    }
+
+    // Long gaps (first frame, or after sleeping) count as one frame
+    qint64 gap = (lastTick < 0 || tNs - lastTick > 100000000) ? intervalNs : tNs - lastTick;
+    float dt = gap * 1e-9f;
+    lastTick = tNs;
+
+    // Next deadline on a fixed grid; skip frames that were missed outright
+    nextFrame += intervalNs;
+    if (nextFrame <= tNs)
+        nextFrame = tNs + intervalNs;
+
+    for (std::size_t i = 0; i < animations.size(); ++i) {
+        // Copy: a tick may register other animations and reallocate
+        Tick tick = animations[i].tick;
+        if (!animations[i].owner || !tick || !tick(t, dt))
+            animations[i].tick = nullptr;
+    }
+    animations.erase(std::remove_if(animations.begin(), animations.end(),
+                                    [](const Animation& a) { return !a.tick || !a.owner; }),
+                     animations.end());
+
+    ticking = false;
+    emit frameFinished();
+    rearm();
+}
+
+void FrameClock::rearm() {
+    if (!animations.empty()) {
+        qint64 t = clock.nsecsElapsed();
+        if (lastTick < 0) {
+            // First frame after idling runs right away
+            framePending = false;
+            timer.start(0);
+            return;
+        }
+        if (!sourceWindow && !sourceView) {
+            timer.start(delayUntil(nextFrame, t));
+            return;
+        }
+        // Already requested: the watchdog or deadline timer is running
+        if (framePending) return;
+        framePending = true;
+        if (sourceWindow)
+            sourceWindow->requestUpdate();
+        else
+            sourceView->update();
+        // Watchdog in case the source stops presenting (hidden, minimised)
+        timer.start(delayUntil(nextFrame + intervalNs, t));
+        return;
+    }
+    lastTick = -1;
+    framePending = false;
+
+    if (pending.empty()) {
+        timer.stop();
+        return;
+    }
+    qint64 nearest = std::min_element(pending.begin(), pending.end(),
+        [](const Pending& a, const Pending& b) { return a.due < b.due; })->due;
+    timer.start(int(qMax<qint64>(0, nearest - now())));
+}
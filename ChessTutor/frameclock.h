@@ -0,0 +1,231 @@
+/*
+ * frameclock.h
+ *
+ * Defines the FrameClock class, the single timing source for everything
+ * that moves on screen: piece slides, confetti and delayed game actions.
+ * All animations advance on the same tick, repaints requested during a
+ * tick are flushed once at its end, and the clock stops completely when
+ * nothing is animating or waiting. Ticks follow the display: they are
+ * paced by the board window's update requests or the OpenGL view's buffer
+ * swaps, with a timer on absolute deadlines only as a fallback.
+ *
+ * @author  ESL Team
+ * @date    2026-10-16
+ */
+#ifndef FRAMECLOCK_H
+#define FRAMECLOCK_H
+
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <functional>
+#include <vector>
+
+class QOpenGLWidget;
+class QWindow;
+
+/**
+ * FrameClock
+ *
+ * Display-rate tick shared by all animations. Animations register a tick
+ * function per owner; delayed actions are queued with schedule(). While
+ * only delayed actions are pending the clock sleeps until the nearest
+ * one is due instead of ticking every frame.
+ *
+ * With a frame source set, each animation frame is requested from it and
+ * runs when the display presents; otherwise, or if the source stops
+ * presenting, a timer ticks on a grid of absolute deadlines one refresh
+ * interval apart.
+ */
+class FrameClock : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * Tick
+     *
+     * Advances one animation. Receives the clock time in milliseconds and
+     * the seconds since the previous tick; returns false once finished.
+     */
+    using Tick = std::function<bool(qint64 nowMs, float dt)>;
+
+    /**
+     * Constructor
+     *
+     * @param parent Optional parent QObject.
+     */
+    explicit FrameClock(QObject* parent = nullptr);
+
+    /**
+     * shared
+     *
+     * @return Clock used by the board, confetti and game flow.
+     */
+    static FrameClock& shared();
+
+    /**
+     * animate
+     *
+     * Register (or replace) the tick function of an owner and make sure
+     * the clock is running. The tick is dropped when it returns false or
+     * the owner is destroyed.
+     *
+     * @param owner Object the animation belongs to.
+     * @param tick  Function called once per frame.
+     */
+    void animate(QObject* owner, Tick tick);
+
+    /**
+     * cancel
+     *
+     * Remove an owner's tick function, if any.
+     */
+    void cancel(QObject* owner);
+
+    /**
+     * schedule
+     *
+     * Run an action on the first frame at least delayMs from now. Replaces
+     * QTimer::singleShot so delayed moves land on frame boundaries.
+     *
+     * @param delayMs Delay in milliseconds.
+     * @param context Action is dropped if this object is destroyed first.
+     * @param action  Function to run.
+     */
+    void schedule(int delayMs, QObject* context, std::function<void()> action);
+
+    /**
+     * setFrameSource
+     *
+     * Pace animation frames by a window's update requests
+     * (QWindow::requestUpdate, delivered at the display's refresh). Replaces
+     * any previous source; null falls back to the timer.
+     *
+     * @param window Top-level window the board is painted in.
+     */
+    void setFrameSource(QWindow* window);
+
+    /**
+     * setFrameSource
+     *
+     * Pace animation frames by an OpenGL view's buffer swaps. Replaces any
+     * previous source; null falls back to the timer.
+     *
+     * @param view View whose frameSwapped signal starts the next frame.
+     */
+    void setFrameSource(QOpenGLWidget* view);
+
+    /**
+     * now
+     *
+     * @return Milliseconds since the clock was created.
+     */
+    qint64 now() const { return clock.elapsed(); }
+
+    /**
+     * inFrame
+     *
+     * @return True while tick functions are running; repaints requested
+     *         now should wait for frameFinished.
+     */
+    bool inFrame() const { return ticking; }
+
+    /**
+     * isRunning
+     *
+     * @return True if the clock will wake up again.
+     */
+    bool isRunning() const { return timer.isActive() || framePending; }
+
+    /**
+     * frameInterval
+     *
+     * @return Milliseconds between ticks while animating, from the
+     *         frame source's (or primary) screen refresh rate, unrounded.
+     */
+    double frameInterval() const { return intervalNs / 1e6; }
+
+protected:
+    /**
+     * eventFilter
+     *
+     * Runs the requested frame when the source window's update request
+     * arrives, before the window paints.
+     */
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
+signals:
+    /**
+     * frameFinished
+     *
+     * Emitted after every tick function has run, so views can issue one
+     * coalesced repaint for the frame.
+     */
+    void frameFinished();
+
+private:
+    /**
+     * onTimer
+     *
+     * Timer wake-up: a due action, a frame when there is no source, or a
+     * frame the source failed to present.
+     */
+    void onTimer();
+
+    /**
+     * onPresented
+     *
+     * The frame source presented; run the frame if one was requested.
+     */
+    void onPresented();
+
+    /**
+     * runFrame
+     *
+     * Run due actions and all animations, then re-arm or stop.
+     */
+    void runFrame();
+
+    /**
+     * rearm
+     *
+     * Pick the next wake-up: the next presented frame (or frame deadline)
+     * while animating, the nearest action while only waiting, or never
+     * when idle.
+     */
+    void rearm();
+
+    /**
+     * clearFrameSource
+     *
+     * Stop listening to the current frame source.
+     */
+    void clearFrameSource();
+
+    struct Animation {
+        QPointer<QObject> owner;  ///< Owner; null once destroyed
+        Tick              tick;   ///< Per-frame function
+    };
+
+    struct Pending {
+        qint64                due;      ///< Clock time to run at
+        QPointer<QObject>     context;  ///< Dropped if destroyed
+        std::function<void()> action;   ///< What to run
+    };
+
+    QTimer                 timer;        ///< Single-shot wake-up timer
+    QElapsedTimer          clock;        ///< Monotonic time base
+    std::vector<Animation> animations;   ///< Active per-frame ticks
+    std::vector<Pending>   pending;      ///< Delayed actions
+    qint64                 lastTick{-1}; ///< Time of the previous animation tick, ns
+    qint64                 nextFrame{0}; ///< Deadline of the next frame, ns
+    qint64                 intervalNs{16666667}; ///< Frame interval in ns
+    bool                   ticking{false};      ///< True inside runFrame
+    bool                   framePending{false}; ///< A frame was requested from the source
+    QPointer<QWindow>       sourceWindow; ///< Window whose update requests pace frames
+    QPointer<QOpenGLWidget> sourceView;   ///< View whose buffer swaps pace frames
+    QMetaObject::Connection swapConnection; ///< sourceView's frameSwapped
+};
+
+#endif // FRAMECLOCK_H
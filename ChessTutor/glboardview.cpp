@@ -0,0 +1,243 @@
+#include "glboardview.h"
+#include "chessboard.h"
+#include "confetticontroller.h"
+#include <QImage>
+#include <QPainter>
+#include <QSurfaceFormat>
+#include <QVector2D>
+#include <cstddef>
+#include <iostream>
+
+using std::cout;
+using std::endl;
+
+static const char* kVertexShader = R"(
+#version 330 core
+layout(location = 0) in vec2 corner;
+layout(location = 1) in vec4 rect;
+layout(location = 2) in float angle;
+layout(location = 3) in vec4 uv;
+layout(location = 4) in vec4 tint;
+uniform vec2 viewport;
+out vec2 vUv;
+out vec4 vTint;
+void main() {
+    vec2 local = corner * rect.zw;
+    float c = cos(angle), s = sin(angle);
+    vec2 p = rect.xy + vec2(c * local.x - s * local.y, s * local.x + c * local.y);
+    gl_Position = vec4(p.x / viewport.x * 2.0 - 1.0, 1.0 - p.y / viewport.y * 2.0, 0.0, 1.0);
+    vUv = mix(uv.xy, uv.zw, corner * 0.5 + 0.5);
+    vTint = tint;
+}
+)";
+
+static const char* kFragmentShader = R"(
+#version 330 core
+uniform sampler2D atlas;
+in vec2 vUv;
+in vec4 vTint;
+out vec4 fragColor;
+void main() {
+    fragColor = texture(atlas, vUv) * vTint;
+}
+)";
+
+BoardGLView::BoardGLView(ChessBoard *board)
+    : QOpenGLWidget(board),
+    board(board)
+{
+    QSurfaceFormat format;
+    format.setVersion(3, 3);
+    format.setProfile(QSurfaceFormat::CoreProfile);
+    setFormat(format);
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+}
+
+BoardGLView::~BoardGLView() {
+    if (!vao) return;
+    makeCurrent();
+    glDeleteVertexArrays(1, &vao);
+    glDeleteBuffers(1, &cornerBuffer);
+    glDeleteBuffers(1, &instanceBuffer);
+    glDeleteTextures(1, &boardTexture);
+    glDeleteTextures(1, &atlasTexture);
+    doneCurrent();
+}
+
+void BoardGLView::initializeGL() {
+    initializeOpenGLFunctions();
+
+    QSurfaceFormat actual = context()->format();
+    bool recentEnough = actual.version() >= qMakePair(3, 3);
+    if (!recentEnough
+        || !program.addShaderFromSourceCode(QOpenGLShader::Vertex, kVertexShader)
+        || !program.addShaderFromSourceCode(QOpenGLShader::Fragment, kFragmentShader)
+        || !program.link()) {
+        cout << "OpenGL board unavailable, using the raster renderer" << endl;
+        usable = false;
+        emit initFailed();
+        return;
+    }
+    cout << "OpenGL board on " << reinterpret_cast<const char*>(glGetString(GL_RENDERER)) << endl;
+
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+
+    static const float corners[8] = { -1, -1,  1, -1,  -1, 1,  1, 1 };
+    glGenBuffers(1, &cornerBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, cornerBuffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+    glGenBuffers(1, &instanceBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    const GLsizei stride = sizeof(Instance);
+    const struct { GLuint index; GLint size; std::size_t offset; } attributes[] = {
+        { 1, 4, offsetof(Instance, cx) },
+        { 2, 1, offsetof(Instance, angle) },
+        { 3, 4, offsetof(Instance, u0) },
+        { 4, 4, offsetof(Instance, r) },
+    };
+    for (auto const& a : attributes) {
+        glEnableVertexAttribArray(a.index);
+        glVertexAttribPointer(a.index, a.size, GL_FLOAT, GL_FALSE, stride,
+                              reinterpret_cast<const void*>(a.offset));
+        glVertexAttribDivisor(a.index, 1);
+    }
+    glBindVertexArray(0);
+
+    boardTexture = uploadTexture(board->boardSource());
+    buildAtlas();
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);  // premultiplied alpha
+}
+
+GLuint BoardGLView::uploadTexture(const QImage& image) {
+    QImage rgba = image.convertToFormat(QImage::Format_RGBA8888_Premultiplied);
+    GLuint texture = 0;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, rgba.width(), rgba.height(), 0,
+                 GL_RGBA, GL_UNSIGNED_BYTE, rgba.constBits());
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    return texture;
+}
+
+void BoardGLView::buildAtlas() {
+    QImage atlas(13 * kAtlasCell, kAtlasCell, QImage::Format_RGBA8888_Premultiplied);
+    atlas.fill(Qt::transparent);
+    QPainter p(&atlas);
+    p.setRenderHint(QPainter::SmoothPixmapTransform);
+    for (int i = 0; i < 12; ++i)
+        p.drawImage(QRect(i * kAtlasCell, 0, kAtlasCell, kAtlasCell), board->pieceSource(i));
+    p.fillRect(QRect(12 * kAtlasCell, 0, kAtlasCell, kAtlasCell), Qt::white);
+    p.end();
+    atlasTexture = uploadTexture(atlas);
+}
+
+void BoardGLView::pushSolid(float cx, float cy, float hw, float hh, float angle,
+                            const QColor& color, float alpha) {
+    // Sample the middle of the white cell so every fragment reads pure white
+    const float u = 12.5f / 13.0f;
+    float a = float(color.alphaF()) * alpha;
+    instances.push_back({ cx, cy, hw, hh, angle, u, 0.5f, u, 0.5f,
+                          float(color.redF()) * a, float(color.greenF()) * a,
+                          float(color.blueF()) * a, a });
+}
+
+void BoardGLView::drawInstances(GLuint texture) {
+    if (instances.empty()) return;
+
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    std::size_t bytes = instances.size() * sizeof(Instance);
+    if (bytes > instanceCapacity) {
+        instanceCapacity = bytes * 2;
+        glBufferData(GL_ARRAY_BUFFER, GLsizeiptr(instanceCapacity), nullptr, GL_STREAM_DRAW);
+    }
+    glBufferSubData(GL_ARRAY_BUFFER, 0, GLsizeiptr(bytes), instances.data());
+
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, GLsizei(instances.size()));
+    instances.clear();
+}
+
+void BoardGLView::reloadTextures() {
+    texturesStale = true;
+    update();
+}
+
+void BoardGLView::paintGL() {
+    glClearColor(0, 0, 0, 0);
+    glClear(GL_COLOR_BUFFER_BIT);
+    if (!usable) return;
+
+    if (texturesStale) {
+        glDeleteTextures(1, &boardTexture);
+        glDeleteTextures(1, &atlasTexture);
+        boardTexture = uploadTexture(board->boardSource());
+        buildAtlas();
+        texturesStale = false;
+    }
+
+    program.bind();
+    program.setUniformValue("viewport", QVector2D(width(), height()));
+    program.setUniformValue("atlas", 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindVertexArray(vao);
+
+    // Background: one quad
+    QRect boardRect = board->squareRect(0, 0).united(board->squareRect(7, 7));
+    QPointF centre = QRectF(boardRect).center();
+    instances.push_back({ float(centre.x()), float(centre.y()),
+                          boardRect.width() / 2.0f, boardRect.height() / 2.0f, 0.0f,
+                          0.0f, 0.0f, 1.0f, 1.0f, 1, 1, 1, 1 });
+    drawInstances(boardTexture);
+
+    // Pieces, hints and confetti share the atlas and go in one call, in
+    // back-to-front order.
+    for (int i = 0; i < 8; ++i) {
+        for (int j = 0; j < 8; ++j) {
+            int cell = ChessBoard::atlasIndex(board->displayedPiece(i, j));
+            if (cell < 0) continue;
+            QRectF r = board->squareRect(i, j);
+            instances.push_back({ float(r.center().x()), float(r.center().y()),
+                                  float(r.width()) / 2, float(r.height()) / 2, 0.0f,
+                                  cell / 13.0f, 0.0f, (cell + 1) / 13.0f, 1.0f,
+                                  1, 1, 1, 1 });
+        }
+    }
+
+    QRectF slideRect;
+    int slidePiece;
+    if (board->slidingPiece(slideRect, slidePiece)) {
+        int cell = ChessBoard::atlasIndex(slidePiece);
+        instances.push_back({ float(slideRect.center().x()), float(slideRect.center().y()),
+                              float(slideRect.width()) / 2, float(slideRect.height()) / 2, 0.0f,
+                              cell / 13.0f, 0.0f, (cell + 1) / 13.0f, 1.0f,
+                              1, 1, 1, 1 });
+    }
+
+    const QColor overlay(255, 255, 0, 100);
+    QRegion hints = board->hintRegion();
+    for (const QRect& r : hints) {
+        QRectF f(r);
+        pushSolid(f.center().x(), f.center().y(), f.width() / 2, f.height() / 2, 0.0f, overlay, 1.0f);
+    }
+
+    if (board->confetti) {
+        board->confetti->collectQuads(confettiQuads);
+        for (auto const& q : confettiQuads)
+            pushSolid(q.x, q.y, q.half, q.half, q.angle, q.color, q.alpha);
+    }
+    drawInstances(atlasTexture);
+
+    glBindVertexArray(0);
+    program.release();
+}
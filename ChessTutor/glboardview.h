@@ -0,0 +1,136 @@
+/*
+ * glboardview.h
+ *
+ * Defines the BoardGLView widget, an optional OpenGL render path for
+ * ChessBoard. The board is one textured quad; pieces, hint overlays and
+ * confetti are instanced quads from a single atlas texture, drawn in one
+ * call. Needs OpenGL 3.3 core, which Mesa's llvmpipe software rasterizer
+ * provides, so it runs without a GPU.
+ *
+ * @author  ESL Team
+ * @date    2026-10-16
+ */
+#ifndef GLBOARDVIEW_H
+#define GLBOARDVIEW_H
+
+#include <QOpenGLWidget>
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLShaderProgram>
+#include <vector>
+
+class ChessBoard;
+struct ConfettiQuad;
+
+/**
+ * BoardGLView
+ *
+ * Child widget covering a ChessBoard and rendering its state with OpenGL.
+ * It is transparent for mouse events, so input still reaches the board.
+ */
+class BoardGLView : public QOpenGLWidget, protected QOpenGLExtraFunctions {
+    Q_OBJECT
+
+public:
+    /**
+     * Constructor
+     *
+     * @param board Board whose state is drawn; also the parent widget.
+     */
+    explicit BoardGLView(ChessBoard *board);
+
+    /**
+     * Destructor
+     *
+     * Releases GL buffers and textures in the widget's context.
+     */
+    ~BoardGLView() override;
+
+    /**
+     * isUsable
+     *
+     * @return False once GL setup has failed and the raster path should be used.
+     */
+    bool isUsable() const { return usable; }
+
+    /**
+     * reloadTextures
+     *
+     * Re-upload the board and atlas textures on the next frame, after the
+     * board's images finished loading.
+     */
+    void reloadTextures();
+
+signals:
+    /**
+     * initFailed
+     *
+     * Emitted when the context is too old or the shaders do not build.
+     */
+    void initFailed();
+
+protected:
+    void initializeGL() override;
+    void paintGL() override;
+
+private:
+    /**
+     * Instance
+     *
+     * Per-quad data uploaded to the instance buffer.
+     */
+    struct Instance {
+        float cx, cy;         ///< Centre in widget pixels
+        float hw, hh;         ///< Half width/height in pixels
+        float angle;          ///< Clockwise rotation in radians
+        float u0, v0, u1, v1; ///< Texture rectangle
+        float r, g, b, a;     ///< Premultiplied tint
+    };
+
+    /**
+     * uploadTexture
+     *
+     * Create a linear-filtered texture from an image (row 0 at v = 0).
+     */
+    GLuint uploadTexture(const QImage& image);
+
+    /**
+     * buildAtlas
+     *
+     * Pack the 12 piece images (or their placeholders) and a white cell (for untextured quads)
+     * into the atlas texture.
+     */
+    void buildAtlas();
+
+    /**
+     * pushSolid
+     *
+     * Queue an untextured, tinted quad.
+     */
+    void pushSolid(float cx, float cy, float hw, float hh, float angle,
+                   const QColor& color, float alpha);
+
+    /**
+     * drawInstances
+     *
+     * Upload queued instances and draw them with a texture in one call.
+     */
+    void drawInstances(GLuint texture);
+
+    ChessBoard*               board;              ///< Source of board, hints and confetti
+    QOpenGLShaderProgram      program;            ///< Instanced quad shader
+    GLuint                    vao{0};             ///< Vertex layout
+    GLuint                    cornerBuffer{0};    ///< Static unit-quad corners
+    GLuint                    instanceBuffer{0};  ///< Streamed per-quad data
+    GLuint                    boardTexture{0};    ///< Background image
+    GLuint                    atlasTexture{0};    ///< Pieces plus white cell
+    std::size_t               instanceCapacity{0};///< Bytes allocated in instanceBuffer
+    std::vector<Instance>     instances;          ///< Quads queued for the next draw
+    std::vector<ConfettiQuad> confettiQuads;      ///< Scratch for confetti state
+    bool                      usable{true};       ///< False after a failed init
+    bool                      texturesStale{false};///< Re-upload textures before drawing
+
+    /// Side of one atlas cell in texels
+    static constexpr int kAtlasCell = 128;
+};
+
+#endif // GLBOARDVIEW_H
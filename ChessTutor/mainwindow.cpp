@@ -4,6 +4,9 @@
 #include "ui_mainwindow.h"
 #include "chess.h"
 #include "chesspuzzle.h"
+#include "frameclock.h"
+#include "assetmanager.h"
+#include "pieceset.h"
 #include <iostream>
 #include <QDir>
 #include <QTime>
@@ -13,6 +16,7 @@
 #include <QCoreApplication>
 #include <QRandomGenerator>
 #include <QMessageBox>
+#include <QEvent>
 #include <cmath>
 
 using std::cout;
@@ -29,21 +33,44 @@ MainWindow::MainWindow(QWidget *parent)
     ui->timeEdit->setReadOnly(true);
 
     liveTimer = new QTimer(this);
-    connect(liveTimer, &QTimer::timeout, this, [this]() {
-        qint64 ms    = puzzleTimer.elapsed();
-        int    secs  = int(ms / 1000);
-        int    mins  = secs / 60;
-        secs %= 60;
-        int    milli = int(ms % 1000);
-        ui->timeEdit->setTime(QTime{0, mins, secs, milli});
-    });
+    liveTimer->setSingleShot(true);
+    liveTimer->setTimerType(Qt::PreciseTimer);  // fire on the boundary, not up to 5% early
+    connect(liveTimer, &QTimer::timeout, this, &MainWindow::refreshClockDisplay);
 
     // Setup Elo label in status bar
     ui->eloLabel->setText(QString("Elo: %1").arg(currentElo));
 
+    // Optional SVG pieces: $CHESSTUTOR_PIECES or a pieces folder beside the executable
+    QString piecesPath = qEnvironmentVariable("CHESSTUTOR_PIECES");
+    if (piecesPath.isEmpty())
+        piecesPath = QDir(QApplication::applicationDirPath()).filePath("pieces");
+    if (PieceSet::shared().load(piecesPath))
+        cout << "Loaded SVG pieces from " << piecesPath.toStdString() << endl;
+
     boardVisuals = new ChessBoard(ui->boardFrame);
+    // The board scales with the frame it sits in
+    auto* boardLayout = new QVBoxLayout(ui->boardFrame);
+    boardLayout->setContentsMargins(0, 0, 0, 0);
+    boardLayout->addWidget(boardVisuals);
     m_confetti = new ConfettiController(boardVisuals, this);
     boardVisuals->setConfettiController(m_confetti);
+    if (qEnvironmentVariable("CHESSTUTOR_CONFETTI").compare("particles", Qt::CaseInsensitive) == 0)
+        m_confetti->setBackend(ConfettiController::Backend::Particles);
+    // Extra or replacement effects: $CHESSTUTOR_EFFECTS or effects.json beside the executable
+    QString effectsPath = qEnvironmentVariable("CHESSTUTOR_EFFECTS");
+    if (effectsPath.isEmpty())
+        effectsPath = QDir(QApplication::applicationDirPath()).filePath("effects.json");
+    if (QFile::exists(effectsPath)) {
+        QString error;
+        if (m_confetti->effects().load(effectsPath, &error))
+            cout << "Loaded effects from " << effectsPath.toStdString() << endl;
+        else
+            cout << "Could not load effects from " << effectsPath.toStdString() << ": " << error.toStdString() << endl;
+    }
+    sounds = new SoundManager(this);
+    // Opt-in GPU path; works on llvmpipe (LIBGL_ALWAYS_SOFTWARE=1) too
+    if (qEnvironmentVariable("CHESSTUTOR_RENDERER").compare("opengl", Qt::CaseInsensitive) == 0)
+        boardVisuals->setRenderer(ChessBoard::Renderer::OpenGL);
     Chess blank{};
     boardVisuals->setBoardState(blank.getBoardVector());
 
@@ -56,34 +83,48 @@ MainWindow::MainWindow(QWidget *parent)
     connect(ui->nextPuzzleButton, &QPushButton::clicked,
             this, &MainWindow::makeNewPuzzle);
 
-    // Asset loading setup
-    QDir dir(QApplication::applicationDirPath());
-    dir.cdUp();
-    dir.cdUp();
-    dir.cdUp();
-
-    // Loads title icon
-    QString titlePath = dir.filePath(":/Assets/Assets/Title.png");
-    QImage title{titlePath};
-    QPixmap titleMap = QPixmap::fromImage(title);
-    ui->Title->setPixmap(titleMap);
+    // Images decode in the background so the window shows at once; the
+    // buttons are usable before their icons arrive.
+    AssetManager& assets = AssetManager::shared();
+    assets.load(":/Assets/Assets/Title.png", this, [this](const QImage& title) {
+        ui->Title->setPixmap(QPixmap::fromImage(title));
+    });
     ui->Title->show();
 
-    // Loads standard game icon
+    // Icons are pre-scaled for the screen so QIcon never rescales them
     QSize iconSize{140, 140};
-    QString standardPath = dir.filePath(":/Assets/Assets/Standard.png");
-    QIcon standardIcon{standardPath};
+    qreal dpr = devicePixelRatioF();
+    auto setIcon = [dpr](QPushButton* button) {
+        return [button, dpr](const QImage& img) {
+            QPixmap pixmap = QPixmap::fromImage(img);
+            pixmap.setDevicePixelRatio(dpr);
+            button->setIcon(QIcon(pixmap));
+        };
+    };
+
+    // Loads standard game icon
     ui->BoardButton->setText("");
-    ui->BoardButton->setIcon(standardIcon);
     ui->BoardButton->setIconSize(iconSize);
+    assets.load(":/Assets/Assets/Standard.png", ui->BoardButton, setIcon(ui->BoardButton), iconSize * dpr);
 
     // Loads Puzzle Icon
-    QString puzzlePath = dir.filePath(":/Assets/Assets/Puzzle.png");
-    QIcon puzzleIcon{puzzlePath};
     ui->PuzzleButton->setText("");
-    ui->PuzzleButton->setIcon(puzzleIcon);
     ui->PuzzleButton->setIconSize(iconSize);
-
+    assets.load(":/Assets/Assets/Puzzle.png", ui->PuzzleButton, setIcon(ui->PuzzleButton), iconSize * dpr);
+
+    // Endgame tablebases: $CHESSTUTOR_SYZYGY or a syzygy folder beside the executable
+    QString syzygyPath = qEnvironmentVariable("CHESSTUTOR_SYZYGY");
+    if (syzygyPath.isEmpty())
+        syzygyPath = QDir(QApplication::applicationDirPath()).filePath("syzygy");
+    int tables = tablebase.setDirectory(syzygyPath);
+    cout << "Loaded " << tables << " tablebase tables from " << syzygyPath.toStdString() << endl;
+
+    // Opening book: $CHESSTUTOR_BOOK or book.bin beside the executable
+    QString bookPath = qEnvironmentVariable("CHESSTUTOR_BOOK");
+    if (bookPath.isEmpty())
+        bookPath = QDir(QApplication::applicationDirPath()).filePath("book.bin");
+    if (openingBook.open(bookPath))
+        cout << "Loaded " << openingBook.size() << " book entries from " << bookPath.toStdString() << endl;
 }
 
 // Check FEN castling field is exactly "-" and themes lack "enPassant"
@@ -143,8 +184,33 @@ void MainWindow::onHintAvailable(int fr, int fc) {
     boardVisuals->setHintSquares(fr, fc, fr, fc);
 }
 
+bool MainWindow::standardHint(int& fromRow, int& fromCol, int& toRow, int& toCol) {
+    BookMove book;
+    if (currentGame->bookHint(book)) {
+        fromRow = book.fromRow; fromCol = book.fromCol;
+        toRow = book.toRow;     toCol = book.toCol;
+        return true;
+    }
+    TablebaseMove tb;
+    if (currentGame->tablebaseHint(tb)) {
+        fromRow = tb.fromRow; fromCol = tb.fromCol;
+        toRow = tb.toRow;     toCol = tb.toCol;
+        return true;
+    }
+    return false;
+}
+
 void MainWindow::on_hintMoveButton_clicked() {
     hintUsed = true;
+    if (currentGame) {
+        // Standard mode: hints come from the opening book or the tablebase
+        int fr, fc, tr, tc;
+        if (standardHint(fr, fc, tr, tc))
+            boardVisuals->setHintSquares(fr, fc, tr, tc);
+        else
+            statusBar()->showMessage("No book or tablebase hint for this position", 1500);
+        return;
+    }
     if (!currentPuzzle) {
         // no puzzle loaded yet
         return;
@@ -155,6 +221,14 @@ void MainWindow::on_hintMoveButton_clicked() {
 
 void MainWindow::on_hintButton_clicked() {
     hintUsed = true;
+    if (currentGame) {
+        int fr, fc, tr, tc;
+        if (standardHint(fr, fc, tr, tc))
+            boardVisuals->setHintSquares(fr, fc, fr, fc);
+        else
+            statusBar()->showMessage("No book or tablebase hint for this position", 1500);
+        return;
+    }
     if (!currentPuzzle) {
         // no puzzle loaded yet
         return;
@@ -187,7 +261,7 @@ void MainWindow::on_solutionButton_clicked() {
 void MainWindow::playSolutionStep() {
     // done?
     if (!currentPuzzle || currentPuzzle->isSolved()) {
-        QTimer::singleShot(2500, this, [this]() {
+        FrameClock::shared().schedule(2500, this, [this]() {
             ui->solutionButton->setEnabled(true);
             ui->BoardButton->setEnabled(true);
             ui->PuzzleButton->setEnabled(true);
@@ -204,7 +278,7 @@ void MainWindow::playSolutionStep() {
     boardVisuals->setHintSquares(fr, fc, tr, tc);
 
     // after 1s, actually perform the move
-    QTimer::singleShot(1000, this, [this, fr, fc, tr, tc]() {
+    FrameClock::shared().schedule(1000, this, [this, fr, fc, tr, tc]() {
         // execute that move
         currentPuzzle->makeGuess({fr,fc}, {tr,tc});
         boardVisuals->setBoardState(currentPuzzle->getBoardVector());
@@ -212,7 +286,7 @@ void MainWindow::playSolutionStep() {
         boardVisuals->clearHint();
 
         // short pause, then step again
-        QTimer::singleShot(500, this, &MainWindow::playSolutionStep);
+        FrameClock::shared().schedule(500, this, [this]() { playSolutionStep(); });
     });
 }
 
@@ -253,7 +327,7 @@ void MainWindow::onSquareSelected(int row, int col){
 
         if(correct){
             ui->statusbar->showMessage("Correct! Next move…", 1500);
-            QTimer::singleShot(1000, this, [this]() {
+            FrameClock::shared().schedule(1000, this, [this]() {
                 ui->hintMoveButton->setEnabled(true),
                     ui->hintButton->setEnabled(true);
             });
@@ -263,7 +337,7 @@ void MainWindow::onSquareSelected(int row, int col){
             ui->statusbar->showMessage("Wrong try again!", 1500);
 
             selected = false;
-            QTimer::singleShot(1000, this, [this]() {
+            FrameClock::shared().schedule(1000, this, [this]() {
                 ui->hintMoveButton->setEnabled(true);
                 ui->hintButton->setEnabled(true);
             });
@@ -280,6 +354,9 @@ void MainWindow::makeNewPuzzle(){
     QString line = randomValidPuzzleLine(":/Data/lichess_db_puzzle_sample_50.csv");
     currentPuzzle = new ChessPuzzle(line.toStdString());
     Player currentPlayer = currentPuzzle->currentPlayer;
+    currentPuzzle->setTablebase(&tablebase);
+    if (!currentPuzzle->agreesWithTablebase())
+        cout << "Tablebase disagrees with the solution of: " << line.toStdString() << endl;
 
     // Signal/slot connections
     connect(currentPuzzle, &ChessPuzzle::hintMoveAvailable, this, &MainWindow::onHintMoveAvailable);
@@ -289,6 +366,11 @@ void MainWindow::makeNewPuzzle(){
     connect(currentPuzzle, &Chess::set_player, this, &MainWindow::on_set_player);
     connect(currentPuzzle, &Chess::capture_at, m_confetti, &ConfettiController::onSpawnAt);
     connect(currentPuzzle, &Chess::won_game, this, &MainWindow::on_game_won);
+    connect(currentPuzzle, &Chess::piece_moved, sounds, &SoundManager::playMove);
+    connect(currentPuzzle, &ChessPuzzle::beatPuzzle, sounds, &SoundManager::playConfetti);
+    // The constructor already made the opponent's first move, before
+    // piece_moved was connected
+    sounds->playMove();
 
     connect(ui->hintMoveButton, &QPushButton::clicked, this, &MainWindow::on_hintMoveButton_clicked);
     connect(currentPuzzle, &ChessPuzzle::hintMoveAvailable, this, &MainWindow::onHintMoveAvailable);
@@ -305,8 +387,7 @@ void MainWindow::makeNewPuzzle(){
     ui->hintButton->setEnabled(true);
 
     // Timer
-    puzzleTimer.restart();
-    liveTimer->start(50);
+    startClockDisplay();
     ui->nextPuzzleButton->setEnabled(false);
     statusBar()->showMessage("Loaded random puzzle!, Solve me!", 1500);
 }
@@ -355,12 +436,15 @@ void MainWindow::on_PuzzleButton_clicked() {
 
 void MainWindow::on_BoardButton_clicked() {
     // Switch into “standard board” mode
-    puzzleTimer.restart();
-    liveTimer->start(50);
+    startClockDisplay();
     currentGame = new Chess;
     currentGame->loadDefaultBoard();
+    currentGame->setTablebase(&tablebase);
+    currentGame->setOpeningBook(&openingBook);
     connect(currentGame, &Chess::capture_at, m_confetti, &ConfettiController::onSpawnAt);
     connect(currentGame, &Chess::won_game, this, &MainWindow::on_game_won);
+    connect(currentGame, &Chess::piece_moved, sounds, &SoundManager::playMove);
+    connect(currentGame, &Chess::won_game, sounds, &SoundManager::playConfetti);
     connect(currentGame, &Chess::set_player, this, &MainWindow::on_set_player);
 
     // Clear any puzzle state
@@ -369,8 +453,9 @@ void MainWindow::on_BoardButton_clicked() {
     // Paint the standard board
     boardVisuals->setBoardState(currentGame->getBoardVector());
     statusBar()->showMessage("Standard board mode", 1000);
-    ui->hintMoveButton->setEnabled(false);
-    ui->hintButton->setEnabled(false);
+    bool haveHints = tablebase.maxPieces() > 0 || openingBook.isOpen();
+    ui->hintMoveButton->setEnabled(haveHints);
+    ui->hintButton->setEnabled(haveHints);
     boardVisuals->clearHintMove();
     boardVisuals->clearHint();
 }
@@ -387,10 +472,11 @@ void MainWindow:: on_update_Board(){
 void MainWindow::on_beat_puzzle(){
     cout << "beat puzzle from obj, making new puzzle" << endl;
 
+    stopClockDisplay();
     assignElo();
-    m_confetti->spawn(300);
+    m_confetti->celebrate("solve");
 
-    QTimer::singleShot(3000, this, &MainWindow::makeNewPuzzle);
+    FrameClock::shared().schedule(3000, this, [this]() { makeNewPuzzle(); });
 }
 
 void MainWindow::on_set_player(Player player){
@@ -419,11 +505,53 @@ void MainWindow::updateEloDisplay() {
 
 void MainWindow::on_game_won() {
     if(currentGame){
-        m_confetti->spawn(300);
-        QTimer::singleShot(3000, this, &MainWindow::on_BoardButton_clicked);
+        m_confetti->celebrate("win");
+        FrameClock::shared().schedule(3000, this, [this]() { on_BoardButton_clicked(); });
     }
 }
 
+void MainWindow::startClockDisplay() {
+    puzzleTimer.restart();
+    clockRunning = true;
+    refreshClockDisplay();
+}
+
+void MainWindow::stopClockDisplay() {
+    clockRunning = false;
+    liveTimer->stop();
+}
+
+int MainWindow::clockPrecisionMs() const {
+    QString format = ui->timeEdit->displayFormat();
+    if (format.contains('z')) return 16;   // no point beating the frame rate
+    if (format.contains('s')) return 1000;
+    return 60000;
+}
+
+void MainWindow::refreshClockDisplay() {
+    if (!clockRunning || isMinimized()) return;
+
+    qint64 ms    = puzzleTimer.elapsed();
+    int    secs  = int(ms / 1000);
+    int    mins  = secs / 60;
+    secs %= 60;
+    int    milli = int(ms % 1000);
+    ui->timeEdit->setTime(QTime{0, mins, secs, milli});
+
+    // Wake exactly when the displayed value next changes, not every 50 ms
+    int step = clockPrecisionMs();
+    liveTimer->start(int(step - ms % step));
+}
+
+void MainWindow::changeEvent(QEvent *event) {
+    QMainWindow::changeEvent(event);
+    if (event->type() != QEvent::WindowStateChange) return;
+    if (isMinimized())
+        liveTimer->stop();
+    else
+        refreshClockDisplay();
+}
+
 MainWindow::~MainWindow()
 {
     delete ui;
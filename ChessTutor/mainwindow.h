@@ -16,6 +16,9 @@
 #include "confetticontroller.h"
 #include "chess.h"
 #include "chesspuzzle.h"
+#include "tablebase.h"
+#include "openingbook.h"
+#include "soundmanager.h"
 #include <vector>
 #include <memory>
 #include <QElapsedTimer>
@@ -126,10 +129,37 @@ private:
     QElapsedTimer puzzleTimer;
 
     /*
-     * Live update timer for the on-screen clock display.
+     * Live update timer for the on-screen clock display. Single-shot and
+     * re-armed for the next moment the shown value changes.
      */
     QTimer *liveTimer = nullptr;
 
+    /*
+     * True while a game or puzzle clock is counting, even if the display
+     * timer is paused because the window is minimized.
+     */
+    bool clockRunning{false};
+
+    /*
+     * Starts the on-screen clock from zero.
+     */
+    void startClockDisplay();
+
+    /*
+     * Stops refreshing the on-screen clock, leaving the last value shown.
+     */
+    void stopClockDisplay();
+
+    /*
+     * Shows the elapsed time and arms liveTimer for the next change.
+     */
+    void refreshClockDisplay();
+
+    /*
+     * Smallest time step the clock's display format can show, in ms.
+     */
+    int clockPrecisionMs() const;
+
     /*
      * Current ELO rating of the player.
      */
@@ -216,6 +246,30 @@ private:
      */
     ConfettiController* m_confetti = nullptr;
 
+    /*
+     * Preloaded move and celebration sounds, played on game signals.
+     */
+    SoundManager* sounds = nullptr;
+
+    /*
+     * Syzygy endgame tablebases from a local folder, used for standard-mode
+     * hints and puzzle validation. Empty when no files are installed.
+     */
+    Tablebase tablebase;
+
+    /*
+     * Polyglot opening book from a local file, used for standard-mode hints
+     * while the game is still in known theory. Closed when no book is installed.
+     */
+    OpeningBook openingBook;
+
+    /*
+     * Looks up a standard-mode hint: the opening book first, then the
+     * endgame tablebase.
+     * @return False if neither knows the position.
+     */
+    bool standardHint(int& fromRow, int& fromCol, int& toRow, int& toCol);
+
 public slots:
     /*
      * Handles user clicks on the board grid.
@@ -240,6 +294,12 @@ public slots:
      */
     void playSolutionStep();
 
+protected:
+    /*
+     * Pauses the clock display while minimized and resumes it after.
+     */
+    void changeEvent(QEvent *event) override;
+
 private slots:
     /*
      * Loads puzzle mode (triggered by the Puzzle button).
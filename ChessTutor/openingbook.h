@@ -0,0 +1,130 @@
+/*
+ * openingbook.h
+ *
+ * Defines the OpeningBook class, which reads Polyglot-format (.bin) opening
+ * books. The file is memory-mapped and entries are found by binary search
+ * on the position hash, so lookups cost a handful of page reads.
+ *
+ * Keys use the standard Polyglot Random64 table, so third-party books
+ * work. The rules core tracks neither castling rights nor en passant, so
+ * a king and rook on their home squares stand in for the castling keys
+ * and the en passant keys are left out; positions right after a double
+ * pawn push that allows an en passant capture will not be found.
+ *
+ * @author  ESL Team
+ * @date    2026-10-16
+ */
+#ifndef OPENINGBOOK_H
+#define OPENINGBOOK_H
+
+#include "chess.h"
+#include <QString>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class QFile;
+
+/**
+ * BookMove
+ *
+ * One book move in board coordinates with its Polyglot weight.
+ */
+struct BookMove{
+    int fromRow{-1};  ///< Row of source square
+    int fromCol{-1};  ///< Column of source square
+    int toRow{-1};    ///< Row of destination square
+    int toCol{-1};    ///< Column of destination square
+    int weight{0};    ///< Relative frequency/quality of the move
+};
+
+/**
+ * OpeningBook
+ *
+ * Read-only Polyglot book backed by a memory-mapped file.
+ */
+class OpeningBook{
+public:
+    /// Size in bytes of one on-disk entry (key, move, weight, learn).
+    static constexpr int kEntrySize = 16;
+
+    OpeningBook();
+    ~OpeningBook();
+
+    /**
+     * open
+     *
+     * Map a book file, replacing any previously opened one.
+     * @param path Path to a .bin book
+     * @return False if the file cannot be read or is not a whole number of entries.
+     */
+    bool open(const QString& path);
+
+    /**
+     * close
+     *
+     * Unmap the current book.
+     */
+    void close();
+
+    /**
+     * isOpen
+     *
+     * @return True while a book is mapped.
+     */
+    bool isOpen() const { return entries != nullptr; }
+
+    /**
+     * size
+     *
+     * @return Number of entries in the mapped book.
+     */
+    std::size_t size() const { return count; }
+
+    /**
+     * lookup
+     *
+     * All book moves for a position, highest weight first.
+     * @param board  8×8 board of piece codes
+     * @param toMove Side to move
+     * @return Moves found (empty if the position is not in the book)
+     */
+    std::vector<BookMove> lookup(const int board[8][8], Player toMove) const;
+
+    /**
+     * pickMove
+     *
+     * Choose a book move at random, in proportion to the weights.
+     * @param board  8×8 board of piece codes
+     * @param toMove Side to move
+     * @param move   Receives the chosen move
+     * @return False if the position is not in the book.
+     */
+    bool pickMove(const int board[8][8], Player toMove, BookMove& move) const;
+
+    /**
+     * positionKey
+     *
+     * Hash a position the way book entries are keyed.
+     * @param board  8×8 board of piece codes
+     * @param toMove Side to move
+     */
+    static uint64_t positionKey(const int board[8][8], Player toMove);
+
+    /**
+     * encodeMove
+     *
+     * Pack a move into the 16-bit Polyglot move field. Castling is written
+     * the Polyglot way, as the king moving onto its own rook.
+     * @param piece Code of the moving piece; a king moving two files from
+     *              the e-file is taken as castling
+     */
+    static uint16_t encodeMove(int fromRow, int fromCol, int toRow, int toCol, int piece = 0);
+
+private:
+    std::unique_ptr<QFile> file;        ///< Open book file (owns the mapping)
+    const uint8_t* entries{nullptr};    ///< Mapped entry array
+    std::size_t    count{0};            ///< Number of entries
+};
+
+#endif // OPENINGBOOK_H
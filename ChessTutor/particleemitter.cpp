@@ -0,0 +1,143 @@
+#include "particleemitter.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr float kPi = 3.14159265359f;
+
+std::uint64_t splitmix64(std::uint64_t& state) {
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+inline std::uint32_t rotl(std::uint32_t x, int k) {
+    return (x << k) | (x >> (32 - k));
+}
+
+} // namespace
+
+ParticleRng::ParticleRng(std::uint64_t seed) {
+    this->seed(seed);
+}
+
+void ParticleRng::seed(std::uint64_t seed) {
+    std::uint64_t state = seed;
+    for (std::size_t l = 0; l < kLanes; ++l) {
+        std::uint64_t a = splitmix64(state);
+        std::uint64_t b = splitmix64(state);
+        s0[l] = std::uint32_t(a);
+        s1[l] = std::uint32_t(a >> 32);
+        s2[l] = std::uint32_t(b);
+        s3[l] = std::uint32_t(b >> 32) | 1u;  // never all zero
+    }
+    used = kLanes;
+}
+
+void ParticleRng::nextBlock(float* out) {
+    // xoshiro128+ on every lane; the top 24 bits become the float mantissa
+    for (std::size_t l = 0; l < kLanes; ++l) {
+        std::uint32_t result = s0[l] + s3[l];
+        std::uint32_t t = s1[l] << 9;
+        s2[l] ^= s0[l];
+        s3[l] ^= s1[l];
+        s1[l] ^= s2[l];
+        s0[l] ^= s3[l];
+        s2[l] ^= t;
+        s3[l] = rotl(s3[l], 11);
+        out[l] = float(result >> 8) * (1.0f / 16777216.0f);
+    }
+}
+
+float ParticleRng::uniform(float lo, float hi) {
+    if (used == kLanes) {
+        nextBlock(block);
+        used = 0;
+    }
+    return lo + (hi - lo) * block[used++];
+}
+
+void ParticleRng::fill(float* out, std::size_t n, float lo, float hi) {
+    const float range = hi - lo;
+    std::size_t i = 0;
+    for (; i + kLanes <= n; i += kLanes) {
+        nextBlock(out + i);
+        for (std::size_t l = 0; l < kLanes; ++l)
+            out[i + l] = lo + range * out[i + l];
+    }
+    for (; i < n; ++i)
+        out[i] = uniform(lo, hi);
+}
+
+ParticleEmitter::ParticleEmitter(std::uint64_t seed)
+    : rng(seed)
+{
+}
+
+void ParticleEmitter::emit(const EmitterPreset& p, float x, float y, int count, std::vector<ParticleSpawn>& out) {
+    out.clear();
+    if (count <= 0) return;
+    const std::size_t n = std::size_t(count);
+    for (auto& c : column)
+        c.resize(n);
+
+    float* place = column[0].data();
+    float* size = column[1].data();
+    float* vx = column[2].data();
+    float* vy = column[3].data();
+    float* impulse = column[4].data();
+    float* dir = column[5].data();
+    float* spin = column[6].data();
+    float* bounce = column[7].data();
+    float* color = column[8].data();
+    const float colors = float(std::max<std::size_t>(1, p.colors.size()));
+    if (p.shape == EmitterPreset::Shape::Ring)
+        rng.fill(place, n, 0.0f, 2.0f * kPi);
+    else
+        rng.fill(place, n, -0.5f * p.extent, 0.5f * p.extent);
+    rng.fill(size, n, p.size.min, p.size.max);
+    rng.fill(vx, n, p.velocityX.min, p.velocityX.max);
+    rng.fill(vy, n, p.velocityY.min, p.velocityY.max);
+    rng.fill(impulse, n, p.impulse.min, p.impulse.max);
+    rng.fill(dir, n, 0.0f, 2.0f * kPi);
+    rng.fill(spin, n, p.spin.min, p.spin.max);
+    rng.fill(bounce, n, p.restitution.min, p.restitution.max);
+    rng.fill(color, n, 0.0f, colors);
+
+    out.resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        ParticleSpawn& s = out[i];
+        switch (p.shape) {
+        case EmitterPreset::Shape::Point:
+            s.x = x;
+            s.y = y;
+            break;
+        case EmitterPreset::Shape::Line:
+            s.x = x + place[i];
+            s.y = y;
+            break;
+        case EmitterPreset::Shape::Ring:
+            s.x = x + p.extent * std::cos(place[i]);
+            s.y = y + p.extent * std::sin(place[i]);
+            break;
+        }
+        s.half = size[i];
+
+        // An impulse on a fresh body is a velocity of impulse / mass
+        float speed = impulse[i] / (4.0f * size[i] * size[i]);  // density 1
+        s.vx = vx[i] + speed * std::cos(dir[i]);
+        s.vy = vy[i] + speed * std::sin(dir[i]);
+        s.spin = spin[i];
+        s.linearDamping = p.linearDamping;
+        s.angularDamping = p.angularDamping;
+        s.life = p.life;
+        s.fade = p.fade;
+        s.gravityScale = p.gravityScale;
+        s.color = p.colors.empty() ? 0 : p.colors[std::min(std::size_t(color[i]), p.colors.size() - 1)];
+        s.restitution = bounce[i];
+        s.friction = p.friction;
+        s.bullet = p.bullet;
+    }
+}
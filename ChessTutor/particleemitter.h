@@ -0,0 +1,156 @@
+/*
+ * particleemitter.h
+ *
+ * Defines ParticleRng, a fast multi-lane random number generator, and
+ * ParticleEmitter, which turns it into batches of ParticleSpawn for the
+ * confetti effects described by an EmitterPreset. The generator is
+ * seeded once and keeps its state, so spawning never touches
+ * std::random_device, and a fixed seed replays the exact same confetti.
+ *
+ * @author  ESL Team
+ * @date    2026-10-16
+ */
+#ifndef PARTICLEEMITTER_H
+#define PARTICLEEMITTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "particlesystem.h"
+
+/**
+ * ParticleRng
+ *
+ * Eight independent xoshiro128+ generators stored lane by lane. Filling
+ * an array advances all lanes together, which compilers turn into SIMD
+ * code; single draws take the lanes in turn.
+ */
+class ParticleRng {
+public:
+    /// Independent generators advanced side by side
+    static constexpr std::size_t kLanes = 8;
+
+    /**
+     * Constructor
+     *
+     * @param seed Any value; equal seeds give equal sequences.
+     */
+    explicit ParticleRng(std::uint64_t seed = 0);
+
+    /**
+     * seed
+     *
+     * Restart every lane from a seed, expanded with splitmix64.
+     */
+    void seed(std::uint64_t seed);
+
+    /**
+     * uniform
+     *
+     * @return One float in [lo, hi).
+     */
+    float uniform(float lo, float hi);
+
+    /**
+     * fill
+     *
+     * Write n floats in [lo, hi) to out.
+     */
+    void fill(float* out, std::size_t n, float lo, float hi);
+
+private:
+    /// Advance every lane once and store one float in [0, 1) per lane
+    void nextBlock(float* out);
+
+    std::uint32_t s0[kLanes], s1[kLanes], s2[kLanes], s3[kLanes];
+    float         block[kLanes];   ///< Unused draws for uniform()
+    std::size_t   used{kLanes};    ///< Draws of block already handed out
+};
+
+/**
+ * FloatRange
+ *
+ * Closed interval a value is drawn uniformly from; min == max is a constant.
+ */
+struct FloatRange {
+    float min{0};
+    float max{0};
+};
+
+/**
+ * EmitterPreset
+ *
+ * Everything needed to generate one effect's particles, in world units.
+ * Presets are usually loaded from JSON by EffectLibrary.
+ */
+struct EmitterPreset {
+    /// Where particles appear relative to the trigger point
+    enum class Shape {
+        Point,  ///< At the point
+        Line,   ///< Along a horizontal line centred on the point
+        Ring    ///< On a circle around the point
+    };
+
+    Shape      shape{Shape::Point};
+    float      extent{0};             ///< Line width or ring radius
+    int        count{0};              ///< Particles per trigger
+    float      rate{0};               ///< Further particles per second while running
+    float      duration{0};           ///< Seconds the rate keeps emitting
+    float      life{3.0f};            ///< Seconds at full opacity
+    float      fade{1.0f};            ///< Seconds fading out
+    FloatRange size{0.03f, 0.08f};    ///< Half side length
+    FloatRange velocityX;             ///< Initial horizontal velocity
+    FloatRange velocityY;             ///< Initial vertical velocity
+    FloatRange impulse;               ///< Outward impulse in a random direction, divided by mass
+    FloatRange spin;                  ///< Angular velocity
+    FloatRange restitution{0.6f, 0.6f}; ///< Box2D only: bounciness
+    float      friction{0.2f};        ///< Box2D only
+    bool       bullet{false};         ///< Box2D only: continuous collision
+    float      linearDamping{0};
+    float      angularDamping{0};
+    float      gravityScale{1.0f};    ///< Multiplier on the world gravity
+    std::vector<std::uint8_t> colors; ///< Palette indices to pick from
+};
+
+/**
+ * ParticleEmitter
+ *
+ * Generates particles for presets. Every random column of a batch
+ * (position, size, velocity, spin, colour, ...) is filled with one
+ * ParticleRng::fill call before the spawns are assembled.
+ */
+class ParticleEmitter {
+public:
+    /**
+     * Constructor
+     *
+     * @param seed Initial seed for the generator.
+     */
+    explicit ParticleEmitter(std::uint64_t seed = 0);
+
+    /**
+     * seed
+     *
+     * Restart the generator, e.g. with a fixed value in tests.
+     */
+    void seed(std::uint64_t seed) { rng.seed(seed); }
+
+    /**
+     * emit
+     *
+     * Generate particles of a preset around a point.
+     *
+     * @param preset What to generate.
+     * @param x      Trigger point x in world units.
+     * @param y      Trigger point y in world units.
+     * @param count  Particles to generate.
+     * @param out    Cleared and filled with the spawns.
+     */
+    void emit(const EmitterPreset& preset, float x, float y, int count, std::vector<ParticleSpawn>& out);
+
+private:
+    ParticleRng        rng;
+    std::vector<float> column[9];           ///< Scratch random columns
+};
+
+#endif // PARTICLEEMITTER_H
@@ -0,0 +1,242 @@
+#include "particlekernel.h"
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define PARTICLE_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// GCC and Clang only emit AVX2 instructions in functions marked for it;
+// MSVC accepts the intrinsics anywhere.
+#if defined(__GNUC__)
+#define PARTICLE_TARGET(isa) __attribute__((target(isa)))
+#else
+#define PARTICLE_TARGET(isa)
+#endif
+
+// One particle, in the same order as b2Island::Solve
+static inline void integrateOne(const ParticleArrays& a, const KernelParams& k, std::size_t i) {
+    const float dt = k.dt;
+    float u = a.vx[i];
+    float v = a.vy[i] + (k.gravity * dt) * a.gravityScale[i];
+    float damp = 1.0f / (1.0f + dt * a.linDamp[i]);
+    u *= damp;
+    v *= damp;
+    float w = a.spin[i] * (1.0f / (1.0f + dt * a.angDamp[i]));
+
+    float mx = u * dt, my = v * dt;
+    float move2 = mx * mx + my * my;
+    if (move2 > k.maxTranslation * k.maxTranslation) {
+        float ratio = k.maxTranslation / std::sqrt(move2);
+        u *= ratio;
+        v *= ratio;
+    }
+
+    float x = a.px[i] + u * dt;
+    if (x < 0.0f) { x = 0.0f; u = std::abs(u); }
+    else if (x > k.worldWidth) { x = k.worldWidth; u = -std::abs(u); }
+
+    a.px[i] = x;
+    a.py[i] += v * dt;
+    a.vx[i] = u;
+    a.vy[i] = v;
+    a.spin[i] = w;
+    a.rot[i] += w * dt;
+    a.ages[i] += dt;
+}
+
+static void integrateScalar(const ParticleArrays& a, const KernelParams& k, std::size_t begin) {
+    for (std::size_t i = begin; i < a.count; ++i)
+        integrateOne(a, k, i);
+}
+
+#ifdef PARTICLE_X86
+
+PARTICLE_TARGET("sse2")
+static void integrateSSE(const ParticleArrays& a, const KernelParams& k) {
+    const __m128 dt = _mm_set1_ps(k.dt);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 g = _mm_set1_ps(k.gravity * k.dt);
+    const __m128 maxMove = _mm_set1_ps(k.maxTranslation);
+    const __m128 maxMove2 = _mm_set1_ps(k.maxTranslation * k.maxTranslation);
+    const __m128 width = _mm_set1_ps(k.worldWidth);
+    const __m128 sign = _mm_set1_ps(-0.0f);
+
+    std::size_t i = 0;
+    for (; i + 4 <= a.count; i += 4) {
+        __m128 u = _mm_loadu_ps(a.vx + i);
+        __m128 v = _mm_add_ps(_mm_loadu_ps(a.vy + i), _mm_mul_ps(g, _mm_loadu_ps(a.gravityScale + i)));
+        __m128 damp = _mm_div_ps(one, _mm_add_ps(one, _mm_mul_ps(dt, _mm_loadu_ps(a.linDamp + i))));
+        u = _mm_mul_ps(u, damp);
+        v = _mm_mul_ps(v, damp);
+        __m128 w = _mm_mul_ps(_mm_loadu_ps(a.spin + i),
+                              _mm_div_ps(one, _mm_add_ps(one, _mm_mul_ps(dt, _mm_loadu_ps(a.angDamp + i)))));
+
+        __m128 mx = _mm_mul_ps(u, dt), my = _mm_mul_ps(v, dt);
+        __m128 move2 = _mm_add_ps(_mm_mul_ps(mx, mx), _mm_mul_ps(my, my));
+        __m128 over = _mm_cmpgt_ps(move2, maxMove2);
+        __m128 ratio = _mm_div_ps(maxMove, _mm_sqrt_ps(move2));
+        ratio = _mm_or_ps(_mm_and_ps(over, ratio), _mm_andnot_ps(over, one));
+        u = _mm_mul_ps(u, ratio);
+        v = _mm_mul_ps(v, ratio);
+
+        __m128 x = _mm_add_ps(_mm_loadu_ps(a.px + i), _mm_mul_ps(u, dt));
+        __m128 absU = _mm_andnot_ps(sign, u);
+        __m128 low = _mm_cmplt_ps(x, zero);
+        __m128 high = _mm_cmpgt_ps(x, width);
+        x = _mm_min_ps(_mm_max_ps(x, zero), width);
+        u = _mm_or_ps(_mm_and_ps(low, absU), _mm_andnot_ps(low, u));
+        u = _mm_or_ps(_mm_and_ps(high, _mm_or_ps(absU, sign)), _mm_andnot_ps(high, u));
+
+        _mm_storeu_ps(a.px + i, x);
+        _mm_storeu_ps(a.py + i, _mm_add_ps(_mm_loadu_ps(a.py + i), _mm_mul_ps(v, dt)));
+        _mm_storeu_ps(a.vx + i, u);
+        _mm_storeu_ps(a.vy + i, v);
+        _mm_storeu_ps(a.spin + i, w);
+        _mm_storeu_ps(a.rot + i, _mm_add_ps(_mm_loadu_ps(a.rot + i), _mm_mul_ps(w, dt)));
+        _mm_storeu_ps(a.ages + i, _mm_add_ps(_mm_loadu_ps(a.ages + i), dt));
+    }
+    integrateScalar(a, k, i);
+}
+
+PARTICLE_TARGET("avx2")
+static void integrateAVX2(const ParticleArrays& a, const KernelParams& k) {
+    const __m256 dt = _mm256_set1_ps(k.dt);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 g = _mm256_set1_ps(k.gravity * k.dt);
+    const __m256 maxMove = _mm256_set1_ps(k.maxTranslation);
+    const __m256 maxMove2 = _mm256_set1_ps(k.maxTranslation * k.maxTranslation);
+    const __m256 width = _mm256_set1_ps(k.worldWidth);
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+
+    std::size_t i = 0;
+    for (; i + 8 <= a.count; i += 8) {
+        __m256 u = _mm256_loadu_ps(a.vx + i);
+        __m256 v = _mm256_add_ps(_mm256_loadu_ps(a.vy + i), _mm256_mul_ps(g, _mm256_loadu_ps(a.gravityScale + i)));
+        __m256 damp = _mm256_div_ps(one, _mm256_add_ps(one, _mm256_mul_ps(dt, _mm256_loadu_ps(a.linDamp + i))));
+        u = _mm256_mul_ps(u, damp);
+        v = _mm256_mul_ps(v, damp);
+        __m256 w = _mm256_mul_ps(_mm256_loadu_ps(a.spin + i),
+                                 _mm256_div_ps(one, _mm256_add_ps(one, _mm256_mul_ps(dt, _mm256_loadu_ps(a.angDamp + i)))));
+
+        __m256 mx = _mm256_mul_ps(u, dt), my = _mm256_mul_ps(v, dt);
+        __m256 move2 = _mm256_add_ps(_mm256_mul_ps(mx, mx), _mm256_mul_ps(my, my));
+        __m256 over = _mm256_cmp_ps(move2, maxMove2, _CMP_GT_OQ);
+        __m256 ratio = _mm256_blendv_ps(one, _mm256_div_ps(maxMove, _mm256_sqrt_ps(move2)), over);
+        u = _mm256_mul_ps(u, ratio);
+        v = _mm256_mul_ps(v, ratio);
+
+        __m256 x = _mm256_add_ps(_mm256_loadu_ps(a.px + i), _mm256_mul_ps(u, dt));
+        __m256 absU = _mm256_andnot_ps(sign, u);
+        __m256 low = _mm256_cmp_ps(x, zero, _CMP_LT_OQ);
+        __m256 high = _mm256_cmp_ps(x, width, _CMP_GT_OQ);
+        x = _mm256_min_ps(_mm256_max_ps(x, zero), width);
+        u = _mm256_blendv_ps(u, absU, low);
+        u = _mm256_blendv_ps(u, _mm256_or_ps(absU, sign), high);
+
+        _mm256_storeu_ps(a.px + i, x);
+        _mm256_storeu_ps(a.py + i, _mm256_add_ps(_mm256_loadu_ps(a.py + i), _mm256_mul_ps(v, dt)));
+        _mm256_storeu_ps(a.vx + i, u);
+        _mm256_storeu_ps(a.vy + i, v);
+        _mm256_storeu_ps(a.spin + i, w);
+        _mm256_storeu_ps(a.rot + i, _mm256_add_ps(_mm256_loadu_ps(a.rot + i), _mm256_mul_ps(w, dt)));
+        _mm256_storeu_ps(a.ages + i, _mm256_add_ps(_mm256_loadu_ps(a.ages + i), dt));
+    }
+    integrateScalar(a, k, i);
+}
+
+static bool cpuHasAVX2() {
+#if defined(__GNUC__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return false;
+#endif
+}
+
+static bool cpuHasSSE2() {
+#if defined(__x86_64__) || defined(_M_X64)
+    return true;  // part of the x86-64 baseline
+#elif defined(__GNUC__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+#else
+    return false;
+#endif
+}
+
+#endif // PARTICLE_X86
+
+bool particleKernelSupported(ParticleKernel kernel) {
+    switch (kernel) {
+    case ParticleKernel::Scalar:
+        return true;
+#ifdef PARTICLE_X86
+    case ParticleKernel::SSE: {
+        static const bool sse = cpuHasSSE2();
+        return sse;
+    }
+    case ParticleKernel::AVX2: {
+        static const bool avx2 = cpuHasAVX2();
+        return avx2;
+    }
+#endif
+    default:
+        return false;
+    }
+}
+
+const char* particleKernelName(ParticleKernel kernel) {
+    switch (kernel) {
+    case ParticleKernel::SSE:  return "sse";
+    case ParticleKernel::AVX2: return "avx2";
+    default:                   return "scalar";
+    }
+}
+
+ParticleKernel bestParticleKernel() {
+    ParticleKernel best = ParticleKernel::Scalar;
+    for (ParticleKernel k : { ParticleKernel::SSE, ParticleKernel::AVX2 })
+        if (particleKernelSupported(k)) best = k;
+
+    if (const char* wanted = std::getenv("CHESSTUTOR_PARTICLE_KERNEL")) {
+        for (ParticleKernel k : { ParticleKernel::Scalar, ParticleKernel::SSE, ParticleKernel::AVX2 })
+            if (std::strcmp(wanted, particleKernelName(k)) == 0 && particleKernelSupported(k))
+                return k;
+    }
+    return best;
+}
+
+void integrateParticles(ParticleKernel kernel, const ParticleArrays& arrays, const KernelParams& params) {
+#ifdef PARTICLE_X86
+    if (kernel == ParticleKernel::AVX2 && particleKernelSupported(kernel)) {
+        integrateAVX2(arrays, params);
+        return;
+    }
+    if (kernel == ParticleKernel::SSE && particleKernelSupported(kernel)) {
+        integrateSSE(arrays, params);
+        return;
+    }
+#else
+    (void)kernel;
+#endif
+    integrateScalar(arrays, params, 0);
+}
@@ -0,0 +1,85 @@
+/*
+ * particlekernel.h
+ *
+ * Integration kernels for ParticleSystem: a portable scalar loop plus
+ * SSE and AVX2 versions for x86, picked at runtime from what the CPU
+ * supports. All three apply gravity, damping, the translation clamp, the
+ * wall bounce and ageing in the same order, so they agree to rounding.
+ *
+ * @author  ESL Team
+ * @date    2026-10-16
+ */
+#ifndef PARTICLEKERNEL_H
+#define PARTICLEKERNEL_H
+
+#include <cstddef>
+
+/**
+ * ParticleArrays
+ *
+ * The arrays a kernel updates in place, all count elements long.
+ */
+struct ParticleArrays {
+    float* px;       ///< Positions
+    float* py;
+    float* vx;       ///< Linear velocities
+    float* vy;
+    float* rot;      ///< Angles
+    float* spin;     ///< Angular velocities
+    const float* linDamp; ///< Linear damping
+    const float* angDamp; ///< Angular damping
+    const float* gravityScale; ///< Multiplier on gravity
+    float* ages;     ///< Seconds since spawn
+    std::size_t count;
+};
+
+/**
+ * KernelParams
+ *
+ * Per-step constants.
+ */
+struct KernelParams {
+    float dt;             ///< Step length in seconds
+    float gravity;        ///< Vertical acceleration
+    float maxTranslation; ///< Per-step movement cap
+    float worldWidth;     ///< Walls at x = 0 and x = worldWidth
+};
+
+/// Available implementations, slowest first
+enum class ParticleKernel {
+    Scalar,
+    SSE,
+    AVX2
+};
+
+/**
+ * bestParticleKernel
+ *
+ * Fastest kernel this CPU runs. CHESSTUTOR_PARTICLE_KERNEL (scalar, sse
+ * or avx2) can ask for a slower one, e.g. to compare them.
+ */
+ParticleKernel bestParticleKernel();
+
+/**
+ * particleKernelSupported
+ *
+ * @return True if the kernel was compiled in and the CPU can run it.
+ */
+bool particleKernelSupported(ParticleKernel kernel);
+
+/**
+ * particleKernelName
+ *
+ * @return "scalar", "sse" or "avx2".
+ */
+const char* particleKernelName(ParticleKernel kernel);
+
+/**
+ * integrateParticles
+ *
+ * Advance every particle by params.dt with the given kernel. Falls back
+ * to the scalar loop if the kernel is not supported.
+ */
+void integrateParticles(ParticleKernel kernel, const ParticleArrays& arrays, const KernelParams& params);
+
+#endif // PARTICLEKERNEL_H
@@ -0,0 +1,92 @@
+#include "particlesystem.h"
+#include <algorithm>
+#include <initializer_list>
+#include <limits>
+
+ParticleSystem::ParticleSystem(const ParticleParams& params)
+    : settings(params),
+    kernel(bestParticleKernel()),
+    cap(std::numeric_limits<std::size_t>::max())
+{
+}
+
+void ParticleSystem::setCapacity(std::size_t capacity) {
+    cap = capacity;
+    for (auto* v : { &px, &py, &ppx, &ppy, &prot, &vx, &vy, &rot, &spin, &linDamp, &angDamp, &halfSize, &ages, &lives, &fades, &gravScale })
+        v->reserve(capacity);
+    colors.reserve(capacity);
+}
+
+bool ParticleSystem::add(const ParticleSpawn& s) {
+    if (px.size() >= cap) return false;
+    px.push_back(s.x);
+    py.push_back(s.y);
+    ppx.push_back(s.x);
+    ppy.push_back(s.y);
+    prot.push_back(s.angle);
+    vx.push_back(s.vx);
+    vy.push_back(s.vy);
+    rot.push_back(s.angle);
+    spin.push_back(s.spin);
+    linDamp.push_back(s.linearDamping);
+    angDamp.push_back(s.angularDamping);
+    halfSize.push_back(s.half);
+    ages.push_back(0.0f);
+    lives.push_back(s.life);
+    fades.push_back(s.fade);
+    gravScale.push_back(s.gravityScale);
+    colors.push_back(s.color);
+    return true;
+}
+
+void ParticleSystem::clear() {
+    for (auto* v : { &px, &py, &ppx, &ppy, &prot, &vx, &vy, &rot, &spin, &linDamp, &angDamp, &halfSize, &ages, &lives, &fades, &gravScale })
+        v->clear();
+    colors.clear();
+}
+
+float ParticleSystem::alpha(std::size_t i) const {
+    float age = ages[i];
+    if (age <= lives[i]) return 1.0f;
+    return std::max(0.0f, 1.0f - (age - lives[i]) / fades[i]);
+}
+
+void ParticleSystem::step(float dt) {
+    const std::size_t n = px.size();
+    ppx.assign(px.begin(), px.end());
+    ppy.assign(py.begin(), py.end());
+    prot.assign(rot.begin(), rot.end());
+
+    ParticleArrays arrays{ px.data(), py.data(), vx.data(), vy.data(), rot.data(), spin.data(),
+                           linDamp.data(), angDamp.data(), gravScale.data(), ages.data(), n };
+    KernelParams k{ dt, settings.gravity, settings.maxTranslation, settings.worldWidth };
+    integrateParticles(kernel, arrays, k);
+}
+
+void ParticleSystem::removeExpired() {
+    const std::size_t n = px.size();
+    // Drop expired particles by moving the last one into their slot
+    std::size_t live = n;
+    for (std::size_t i = 0; i < live; ) {
+        if (ages[i] <= lives[i] + fades[i]) { ++i; continue; }
+        const std::size_t last = --live;
+        px[i] = px[last];   py[i] = py[last];
+        ppx[i] = ppx[last]; ppy[i] = ppy[last];
+        prot[i] = prot[last];
+        vx[i] = vx[last];   vy[i] = vy[last];
+        rot[i] = rot[last]; spin[i] = spin[last];
+        linDamp[i] = linDamp[last];
+        angDamp[i] = angDamp[last];
+        halfSize[i] = halfSize[last];
+        ages[i] = ages[last];
+        lives[i] = lives[last];
+        fades[i] = fades[last];
+        gravScale[i] = gravScale[last];
+        colors[i] = colors[last];
+    }
+    if (live != n) {
+        for (auto* v : { &px, &py, &ppx, &ppy, &prot, &vx, &vy, &rot, &spin, &linDamp, &angDamp, &halfSize, &ages, &lives, &fades, &gravScale })
+            v->resize(live);
+        colors.resize(live);
+    }
+}
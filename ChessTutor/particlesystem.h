@@ -0,0 +1,173 @@
+/*
+ * particlesystem.h
+ *
+ * Defines the ParticleSystem class, a structure-of-arrays confetti engine
+ * used as a lightweight alternative to one Box2D body per particle.
+ * Particles never collide with each other; they fall, spin, damp and
+ * bounce off the side walls, integrated the same way Box2D integrates a
+ * lone body, so both confetti backends look alike.
+ *
+ * @author  ESL Team
+ * @date    2026-10-16
+ */
+#ifndef PARTICLESYSTEM_H
+#define PARTICLESYSTEM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "particlekernel.h"
+
+/**
+ * ParticleSpawn
+ *
+ * Initial state of one particle, in world units (metres, y up).
+ */
+struct ParticleSpawn {
+    float x{0}, y{0};             ///< Position
+    float vx{0}, vy{0};           ///< Linear velocity
+    float angle{0};               ///< Rotation in radians
+    float spin{0};                ///< Angular velocity in radians per second
+    float half{0.05f};            ///< Half the side length
+    float linearDamping{0};       ///< Box2D-style linear damping
+    float angularDamping{0};      ///< Box2D-style angular damping
+    std::uint8_t color{0};        ///< Palette index
+    float life{3.0f};             ///< Seconds at full opacity
+    float fade{1.0f};             ///< Seconds fading out after life
+    float gravityScale{1.0f};     ///< Multiplier on the world gravity
+    float restitution{0.6f};      ///< Box2D only: bounciness
+    float friction{0.2f};         ///< Box2D only: surface friction
+    bool  bullet{false};          ///< Box2D only: continuous collision
+};
+
+/**
+ * ParticleParams
+ *
+ * World settings shared by every particle.
+ */
+struct ParticleParams {
+    float gravity{-0.5f};         ///< Vertical acceleration
+    float worldWidth{8.0f};       ///< Walls at x = 0 and x = worldWidth
+    float maxTranslation{2.0f};   ///< Per-step movement cap, as b2_maxTranslation
+};
+
+/**
+ * ParticleSystem
+ *
+ * Particles live in parallel float arrays so a step is a few tight loops
+ * over contiguous memory, vectorized with SSE or AVX2 where available.
+ * Expired particles are replaced by the last one, so order is not kept.
+ */
+class ParticleSystem {
+public:
+    /**
+     * Constructor
+     *
+     * @param params World settings.
+     */
+    explicit ParticleSystem(const ParticleParams& params = ParticleParams());
+
+    /**
+     * add
+     *
+     * Append one particle with age zero.
+     *
+     * @return False if the system is at capacity and the particle was dropped.
+     */
+    bool add(const ParticleSpawn& spawn);
+
+    /**
+     * step
+     *
+     * Advance every particle by dt seconds. The previous positions and
+     * angles are kept for render interpolation.
+     *
+     * @param dt Step length in seconds.
+     */
+    void step(float dt);
+
+    /**
+     * removeExpired
+     *
+     * Drop particles whose fade-out has ended.
+     */
+    void removeExpired();
+
+    /**
+     * clear
+     *
+     * Remove every particle.
+     */
+    void clear();
+
+    /**
+     * setCapacity
+     *
+     * Cap the number of live particles and reserve the arrays for that
+     * many, so adding never reallocates. Particles already past a lowered
+     * cap live out their lifetime.
+     *
+     * @param capacity Maximum live particles.
+     */
+    void setCapacity(std::size_t capacity);
+
+    /// Maximum live particles
+    std::size_t capacity() const { return cap; }
+
+    /// Number of live particles
+    std::size_t size() const { return px.size(); }
+    bool empty() const { return px.empty(); }
+
+    /// World settings
+    const ParticleParams& params() const { return settings; }
+
+    /**
+     * setKernel
+     *
+     * Choose the integration kernel; unsupported choices run the scalar
+     * loop. Defaults to bestParticleKernel().
+     */
+    void setKernel(ParticleKernel k) { kernel = k; }
+
+    /// Integration kernel in use
+    ParticleKernel currentKernel() const { return kernel; }
+
+    /**
+     * alpha
+     *
+     * @param i Particle index.
+     * @return Opacity from the fade-out, 1 until the particle's life ends.
+     */
+    float alpha(std::size_t i) const;
+
+    // Read-only views of the arrays, indexed 0..size()-1
+    const float* x() const { return px.data(); }
+    const float* prevX() const { return ppx.data(); }   ///< Before the last step
+    const float* prevY() const { return ppy.data(); }   ///< Before the last step
+    const float* prevAngle() const { return prot.data(); } ///< Before the last step
+    const float* y() const { return py.data(); }
+    const float* angle() const { return rot.data(); }
+    const float* half() const { return halfSize.data(); }
+    const float* age() const { return ages.data(); }
+    const std::uint8_t* color() const { return colors.data(); }
+
+private:
+    ParticleParams settings;
+    ParticleKernel kernel;           ///< SIMD or scalar integration
+    std::size_t cap;                 ///< Maximum live particles
+
+    std::vector<float> px, py;       ///< Positions
+    std::vector<float> ppx, ppy, prot; ///< Position and angle before the last step
+    std::vector<float> vx, vy;       ///< Linear velocities
+    std::vector<float> rot, spin;    ///< Angle and angular velocity
+    std::vector<float> linDamp;      ///< Linear damping per particle
+    std::vector<float> angDamp;      ///< Angular damping per particle
+    std::vector<float> halfSize;     ///< Half side length
+    std::vector<float> ages;         ///< Seconds since spawn
+    std::vector<float> lives;        ///< Seconds at full opacity
+    std::vector<float> fades;        ///< Seconds fading out after lives
+    std::vector<float> gravScale;    ///< Multiplier on the world gravity
+    std::vector<std::uint8_t> colors;///< Palette indices
+};
+
+#endif // PARTICLESYSTEM_H
@@ -0,0 +1,182 @@
+#include "pawnhash.h"
+#include "chess.h"
+#include <cstdlib>
+
+// Pawn-structure weights
+static const Score kDoubledPawn{-10, -20};
+static const Score kIsolatedPawn{-10, -15};
+static const Score kBackwardPawn{-8, -10};
+// Passed pawn bonus by number of ranks advanced from the starting rank
+static const int kPassedMg[7]{0, 5, 10, 20, 35, 60, 100};
+static const int kPassedEg[7]{0, 10, 20, 40, 70, 120, 200};
+
+static uint64_t bit(int row, int col){
+    return uint64_t(1) << (row * 8 + col);
+}
+
+static uint64_t splitMix64(uint64_t& state){
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+uint64_t pawnZobrist(int piece, int row, int col){
+    // One key per (side, square), generated once from a fixed seed so keys
+    // are stable between runs.
+    static const struct Keys{
+        uint64_t value[2][64];
+        Keys(){
+            uint64_t state = 0x5041574E48415348ull;
+            for (int side = 0; side < 2; side++)
+                for (int sq = 0; sq < 64; sq++)
+                    value[side][sq] = splitMix64(state);
+        }
+    } keys;
+
+    if (piece == PAWN) return keys.value[0][row * 8 + col];
+    if (piece == -PAWN) return keys.value[1][row * 8 + col];
+    return 0;
+}
+
+void computePawnEntry(const int board[8][8], PawnEntry& entry){
+    uint64_t pawns[2]{};
+    int count[2][8]{};
+    for (int row = 0; row < 8; row++){
+        for (int col = 0; col < 8; col++){
+            if (board[row][col] == PAWN){ pawns[0] |= bit(row, col); count[0][col]++; }
+            else if (board[row][col] == -PAWN){ pawns[1] |= bit(row, col); count[1][col]++; }
+        }
+    }
+
+    // Attacks and attack spans first; the per-pawn terms below need the
+    // opponent's complete sets.
+    for (int side = 0; side < 2; side++){
+        entry.attacks[side] = 0;
+        entry.attackSpans[side] = 0;
+        int forward = side == 0 ? -1 : 1; // White moves toward row 0
+        for (int row = 0; row < 8; row++){
+            for (int col = 0; col < 8; col++){
+                if (!(pawns[side] & bit(row, col))) continue;
+                for (int r = row + forward; r >= 0 && r < 8; r += forward){
+                    for (int c = col - 1; c <= col + 1; c += 2){
+                        if (c < 0 || c > 7) continue;
+                        if (r == row + forward) entry.attacks[side] |= bit(r, c);
+                        entry.attackSpans[side] |= bit(r, c);
+                    }
+                }
+            }
+        }
+    }
+
+    Score score;
+    for (int side = 0; side < 2; side++){
+        int them = 1 - side;
+        int sign = side == 0 ? 1 : -1;
+        int forward = side == 0 ? -1 : 1;
+        entry.passed[side] = 0;
+
+        for (int row = 0; row < 8; row++){
+            for (int col = 0; col < 8; col++){
+                if (!(pawns[side] & bit(row, col))) continue;
+                Score s;
+
+                if (count[side][col] > 1) s += kDoubledPawn;
+
+                bool isolated = (col == 0 || count[side][col - 1] == 0)
+                             && (col == 7 || count[side][col + 1] == 0);
+                if (isolated) s += kIsolatedPawn;
+
+                // Squares in front of the pawn on its own and adjacent files
+                uint64_t front = 0;
+                for (int r = row + forward; r >= 0 && r < 8; r += forward){
+                    for (int c = col - 1; c <= col + 1; c++){
+                        if (c >= 0 && c < 8) front |= bit(r, c);
+                    }
+                }
+
+                if (!(front & pawns[them])){
+                    entry.passed[side] |= bit(row, col);
+                    int advanced = side == 0 ? 6 - row : row - 1;
+                    if (advanced < 0) advanced = 0;
+                    if (advanced > 6) advanced = 6;
+                    s.mg += kPassedMg[advanced];
+                    s.eg += kPassedEg[advanced];
+                }
+                else if (!isolated){
+                    // Backward: no friendly pawn level or behind on an adjacent
+                    // file, and the stop square is held by an enemy pawn.
+                    bool supported = false;
+                    for (int r = row; r >= 0 && r < 8 && !supported; r -= forward){
+                        if (col > 0 && (pawns[side] & bit(r, col - 1))) supported = true;
+                        if (col < 7 && (pawns[side] & bit(r, col + 1))) supported = true;
+                    }
+                    int stop = row + forward;
+                    if (!supported && stop >= 0 && stop < 8
+                        && (entry.attacks[them] & bit(stop, col))){
+                        s += kBackwardPawn;
+                    }
+                }
+
+                score.mg += sign * s.mg;
+                score.eg += sign * s.eg;
+            }
+        }
+    }
+    entry.score = score;
+}
+
+PawnHashTable::PawnHashTable(std::size_t kilobytes){
+    resize(kilobytes);
+}
+
+PawnHashTable& PawnHashTable::shared(){
+    static PawnHashTable table;
+    return table;
+}
+
+void PawnHashTable::resize(std::size_t kilobytes){
+    std::size_t wanted = kilobytes * 1024 / sizeof(PawnEntry);
+    std::size_t count = 1;
+    while (count * 2 <= wanted) count *= 2;
+
+    buckets.assign(count, PawnEntry{});
+    mask = count - 1;
+    resetStats();
+}
+
+void PawnHashTable::clear(){
+    buckets.assign(buckets.size(), PawnEntry{});
+    resetStats();
+}
+
+const PawnEntry& PawnHashTable::probe(uint64_t key, const int board[8][8]){
+    probes++;
+    PawnEntry& entry = buckets[key & mask];
+    if (entry.valid && entry.key == key){
+        hits++;
+        return entry;
+    }
+
+    stores++;
+    computePawnEntry(board, entry);
+    entry.key = key;
+    entry.valid = true;
+    return entry;
+}
+
+PawnHashStats PawnHashTable::stats() const {
+    PawnHashStats s;
+    s.probes = probes;
+    s.hits = hits;
+    s.stores = stores;
+    s.entries = buckets.size();
+    s.bytes = buckets.size() * sizeof(PawnEntry);
+    return s;
+}
+
+void PawnHashTable::resetStats(){
+    probes = 0;
+    hits = 0;
+    stores = 0;
+}
@@ -0,0 +1,145 @@
+/*
+ * pawnhash.h
+ *
+ * Defines the pawn hash table, which caches pawn-structure evaluation keyed
+ * on a pawn-only Zobrist key. Pawn structure changes on few moves, so most
+ * evaluations during a search are answered from the table.
+ *
+ * @author  ESL Team
+ * @date    2026-10-16
+ */
+#ifndef PAWNHASH_H
+#define PAWNHASH_H
+
+#include "evaluation.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * pawnZobrist
+ *
+ * Zobrist key for a pawn on a square. Non-pawn pieces return 0 so callers
+ * can XOR unconditionally on every square write.
+ * @param piece Signed piece code
+ * @param row   Row index (0-7)
+ * @param col   Column index (0-7)
+ * @return Key contribution of the piece
+ */
+uint64_t pawnZobrist(int piece, int row, int col);
+
+/**
+ * PawnEntry
+ *
+ * Cached pawn-structure result for one pawn configuration. Bitboards use
+ * bit (row * 8 + col), index 0 is White and index 1 is Black.
+ */
+struct PawnEntry{
+    uint64_t key{0};          ///< Pawn key this entry was computed for
+    Score    score;           ///< White-minus-black pawn-structure score
+    uint64_t passed[2]{};     ///< Passed pawns per side
+    uint64_t attacks[2]{};    ///< Squares attacked by pawns right now
+    uint64_t attackSpans[2]{};///< Squares pawns could attack by advancing
+    bool     valid{false};    ///< False until the slot has been written
+};
+
+/**
+ * PawnHashStats
+ *
+ * Usage counters for a pawn hash table.
+ */
+struct PawnHashStats{
+    uint64_t probes{0};   ///< Lookups performed
+    uint64_t hits{0};     ///< Lookups answered from the table
+    uint64_t stores{0};   ///< Entries (re)computed and written
+    std::size_t entries{0}; ///< Slot count
+    std::size_t bytes{0};   ///< Memory held by the buckets
+
+    /**
+     * hitRate
+     *
+     * @return Fraction of probes that hit, 0 when nothing has been probed.
+     */
+    double hitRate() const { return probes ? double(hits) / double(probes) : 0.0; }
+};
+
+/**
+ * computePawnEntry
+ *
+ * Evaluate doubled, isolated, backward and passed pawns and fill in the
+ * attack bitboards, without touching any cache.
+ * @param board 8×8 board of piece codes
+ * @param entry Entry to fill; key and valid are left to the caller
+ */
+void computePawnEntry(const int board[8][8], PawnEntry& entry);
+
+/**
+ * PawnHashTable
+ *
+ * Direct-mapped, always-replace cache of PawnEntry records. The slot
+ * count is rounded down to a power of two so a key maps to its slot with
+ * a mask.
+ */
+class PawnHashTable{
+public:
+    /**
+     * Constructor
+     * @param kilobytes Memory budget for the buckets (default 256 KiB).
+     */
+    explicit PawnHashTable(std::size_t kilobytes = 256);
+
+    /**
+     * shared
+     *
+     * @return Table used by every Chess instance that has not been given its own.
+     */
+    static PawnHashTable& shared();
+
+    /**
+     * resize
+     *
+     * Reallocate the buckets for a new memory budget; drops all entries.
+     * @param kilobytes Memory budget for the buckets
+     */
+    void resize(std::size_t kilobytes);
+
+    /**
+     * clear
+     *
+     * Invalidate every entry and reset the counters.
+     */
+    void clear();
+
+    /**
+     * probe
+     *
+     * Look up the pawn structure for a key, computing and storing it on a miss.
+     * @param key   Pawn-only Zobrist key of the position
+     * @param board Board used to compute the entry on a miss
+     * @return Entry for the key; valid until the next probe
+     */
+    const PawnEntry& probe(uint64_t key, const int board[8][8]);
+
+    /**
+     * stats
+     *
+     * @return Current counters and memory size.
+     */
+    PawnHashStats stats() const;
+
+    /**
+     * resetStats
+     *
+     * Zero the probe/hit/store counters without dropping entries.
+     */
+    void resetStats();
+
+private:
+    std::vector<PawnEntry> buckets; ///< Table storage, power-of-two sized
+    uint64_t mask{0};             ///< buckets.size() - 1
+    uint64_t probes{0};           ///< Lookups performed
+    uint64_t hits{0};             ///< Lookups answered from the table
+    uint64_t stores{0};           ///< Entries computed on a miss
+};
+
+#endif // PAWNHASH_H
@@ -0,0 +1,70 @@
+#include "pieceset.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QPainter>
+#include <QSvgRenderer>
+
+PieceSet::PieceSet() = default;
+PieceSet::~PieceSet() = default;
+
+PieceSet& PieceSet::shared() {
+    static PieceSet set;
+    // Pixmaps must go before the application object does
+    static bool registered = (qAddPostRoutine([]() { shared().cache.clear(); }), true);
+    Q_UNUSED(registered);
+    return set;
+}
+
+bool PieceSet::load(const QString& directory) {
+    static const char* names[12]{
+        "WhitePawn", "WhiteRook", "WhiteKnight", "WhiteBishop", "WhiteQueen", "WhiteKing",
+        "BlackPawn", "BlackRook", "BlackKnight", "BlackBishop", "BlackQueen", "BlackKing"
+    };
+
+    cache.clear();
+    loaded = false;
+    QDir dir(directory);
+    std::unique_ptr<QSvgRenderer> parsed[12];
+    for (int i = 0; i < 12; ++i) {
+        parsed[i] = std::make_unique<QSvgRenderer>(dir.filePath(QString("%1.svg").arg(names[i])));
+        if (!parsed[i]->isValid()) return false;
+    }
+    for (int i = 0; i < 12; ++i)
+        pieces[i] = std::move(parsed[i]);
+    loaded = true;
+    return true;
+}
+
+QImage PieceSet::render(int index, int side) const {
+    QImage image(side, side, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    if (!loaded) return image;
+
+    QPainter p(&image);
+    p.setRenderHint(QPainter::Antialiasing);
+    pieces[index]->render(&p, QRectF(0, 0, side, side));
+    return image;
+}
+
+QPixmap PieceSet::atlas(int cell) {
+    if (!loaded || cell <= 0) return QPixmap();
+
+    for (auto it = cache.begin(); it != cache.end(); ++it) {
+        if (it->first != cell) continue;
+        cache.splice(cache.begin(), cache, it);
+        return cache.front().second;
+    }
+
+    QImage strip(12 * cell, cell, QImage::Format_ARGB32_Premultiplied);
+    strip.fill(Qt::transparent);
+    QPainter p(&strip);
+    p.setRenderHint(QPainter::Antialiasing);
+    for (int i = 0; i < 12; ++i)
+        pieces[i]->render(&p, QRectF(i * cell, 0, cell, cell));
+    p.end();
+
+    cache.emplace_front(cell, QPixmap::fromImage(strip));
+    if (cache.size() > kMaxAtlases)
+        cache.pop_back();
+    return cache.front().second;
+}
@@ -0,0 +1,93 @@
+/*
+ * pieceset.h
+ *
+ * Defines the PieceSet class, an optional vector piece set drawn with
+ * QtSvg. Pieces are rasterized once per on-screen size into a shared,
+ * bounded cache, so boards of any size and pixel ratio stay sharp
+ * without shipping PNGs at several resolutions.
+ *
+ * @author  ESL Team
+ * @date    2026-10-16
+ */
+#ifndef PIECESET_H
+#define PIECESET_H
+
+#include <QImage>
+#include <QPixmap>
+#include <QString>
+#include <list>
+#include <memory>
+#include <utility>
+
+class QSvgRenderer;
+
+/**
+ * PieceSet
+ *
+ * Twelve SVG pieces (WhitePawn.svg … BlackKing.svg) loaded from a folder.
+ * atlas() returns all twelve side by side at a given cell size in device
+ * pixels, in ChessBoard::atlasIndex order.
+ */
+class PieceSet {
+public:
+    PieceSet();
+    ~PieceSet();
+    PieceSet(const PieceSet&) = delete;
+    PieceSet& operator=(const PieceSet&) = delete;
+
+    /**
+     * shared
+     *
+     * @return Piece set used by every board widget.
+     */
+    static PieceSet& shared();
+
+    /**
+     * load
+     *
+     * Parse the twelve SVG files in a folder. Replaces any previous set and
+     * empties the cache; on failure the set is left unloaded.
+     *
+     * @param directory Folder holding WhitePawn.svg … BlackKing.svg.
+     * @return True if every file was found and valid.
+     */
+    bool load(const QString& directory);
+
+    /**
+     * isLoaded
+     *
+     * @return True if a complete set is available.
+     */
+    bool isLoaded() const { return loaded; }
+
+    /**
+     * atlas
+     *
+     * Twelve pieces rasterized at exactly cell × cell device pixels, from
+     * the cache when this size was used recently.
+     *
+     * @param cell Side of one piece in device pixels.
+     * @return Atlas 12 cells wide, or a null pixmap if nothing is loaded.
+     */
+    QPixmap atlas(int cell);
+
+    /**
+     * render
+     *
+     * Rasterize one piece, uncached.
+     *
+     * @param index Atlas cell (see ChessBoard::atlasIndex).
+     * @param side  Side of the image in pixels.
+     */
+    QImage render(int index, int side) const;
+
+    /// Atlas sizes kept; enough for a live resize across two screens
+    static constexpr std::size_t kMaxAtlases = 4;
+
+private:
+    std::unique_ptr<QSvgRenderer> pieces[12];       ///< Parsed SVG documents
+    std::list<std::pair<int, QPixmap>> cache;       ///< (cell, atlas), most recent first
+    bool loaded{false};
+};
+
+#endif // PIECESET_H
@@ -0,0 +1,36 @@
+#include "qualitygovernor.h"
+#include <algorithm>
+
+QualityGovernor::QualityGovernor(int levels, double budgetMs)
+    : levels(std::max(1, levels)),
+    budgetMs(budgetMs)
+{
+}
+
+void QualityGovernor::setBudget(double ms) {
+    budgetMs = ms;
+    if (budgetMs <= 0.0) {
+        current = 0;
+        over = under = 0;
+    }
+}
+
+bool QualityGovernor::sample(double ms) {
+    if (budgetMs <= 0.0) return false;
+
+    average = average == 0.0 ? ms : average + kSmoothing * (ms - average);
+    over = average > budgetMs ? over + 1 : 0;
+    under = average < kHeadroom * budgetMs ? under + 1 : 0;
+
+    if (over >= kDegradeFrames && current + 1 < levels) {
+        ++current;
+        over = under = 0;
+        return true;
+    }
+    if (under >= kRestoreFrames && current > 0) {
+        --current;
+        over = under = 0;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,74 @@
+/*
+ * qualitygovernor.h
+ *
+ * Defines the QualityGovernor class, which watches how long each frame
+ * of an effect takes and steps its quality down when a time budget is
+ * exceeded, and back up once there is headroom again.
+ *
+ * @author  ESL Team
+ * @date    2026-10-16
+ */
+#ifndef QUALITYGOVERNOR_H
+#define QUALITYGOVERNOR_H
+
+/**
+ * QualityGovernor
+ *
+ * Level 0 is full quality; higher levels are cheaper. Frame costs are
+ * smoothed, a few frames over budget drop one level, and a long run well
+ * under budget raises one level, so a single slow frame or a brief lull
+ * does not make the quality flicker.
+ */
+class QualityGovernor {
+public:
+    /**
+     * Constructor
+     *
+     * @param levels   Number of quality levels, at least 1.
+     * @param budgetMs Frame budget in milliseconds; 0 disables the governor.
+     */
+    explicit QualityGovernor(int levels, double budgetMs = 4.0);
+
+    /**
+     * setBudget
+     *
+     * Change the budget. A budget of 0 or less returns to full quality
+     * and stops adapting.
+     */
+    void setBudget(double budgetMs);
+
+    /// Frame budget in milliseconds
+    double budget() const { return budgetMs; }
+
+    /// Current level, 0 = full quality
+    int level() const { return current; }
+
+    /**
+     * sample
+     *
+     * Record the cost of one frame.
+     *
+     * @param ms Time the frame's work took, in milliseconds.
+     * @return True if the level changed.
+     */
+    bool sample(double ms);
+
+private:
+    /// Weight of the newest frame in the running average
+    static constexpr double kSmoothing = 0.2;
+    /// Consecutive frames over budget before dropping a level
+    static constexpr int kDegradeFrames = 3;
+    /// Consecutive frames under kHeadroom * budget before raising a level
+    static constexpr int kRestoreFrames = 60;
+    /// Fraction of the budget the average must stay under to restore
+    static constexpr double kHeadroom = 0.5;
+
+    int    levels;
+    double budgetMs;
+    double average{0};   ///< Smoothed frame cost
+    int    over{0};      ///< Frames in a row over budget
+    int    under{0};     ///< Frames in a row with headroom
+    int    current{0};   ///< Current level
+};
+
+#endif // QUALITYGOVERNOR_H
@@ -0,0 +1,47 @@
+#include "soundmanager.h"
+#include <QSoundEffect>
+#include <QUrl>
+
+SoundManager::SoundManager(QObject* parent)
+    : QObject(parent)
+{
+    static const char* sources[kSounds]{
+        "qrc:/Assets/Assets/ChessMove.wav",
+        "qrc:/Assets/Assets/Confetti.wav"
+    };
+
+    // QSoundEffect decodes on setSource and shares the sample between
+    // players of the same URL, so each WAV is decoded once.
+    for (int s = 0; s < kSounds; ++s) {
+        for (auto& voice : voices[s]) {
+            voice = new QSoundEffect(this);
+            voice->setSource(QUrl(sources[s]));
+            voice->setVolume(1.0f);
+        }
+    }
+}
+
+void SoundManager::play(Sound sound) {
+    int s = int(sound);
+    if (s < 0 || s >= kSounds) return;
+
+    auto& pool = voices[s];
+    for (QSoundEffect* voice : pool) {
+        if (voice->isPlaying() || voice->status() != QSoundEffect::Ready) continue;
+        voice->play();
+        return;
+    }
+
+    // Every voice busy (or still loading): restart the oldest one
+    QSoundEffect* voice = pool[nextVoice[s]];
+    nextVoice[s] = (nextVoice[s] + 1) % kVoices;
+    if (voice->status() != QSoundEffect::Ready) return;
+    voice->stop();
+    voice->play();
+}
+
+void SoundManager::setVolume(float volume) {
+    for (auto& pool : voices)
+        for (QSoundEffect* voice : pool)
+            voice->setVolume(volume);
+}
@@ -0,0 +1,76 @@
+/*
+ * soundmanager.h
+ *
+ * Defines the SoundManager class, which loads the game's sound effects
+ * once at startup and plays them from a fixed pool of voices, so moves
+ * neither allocate nor decode audio.
+ *
+ * @author  ESL Team
+ * @date    2026-10-16
+ */
+#ifndef SOUNDMANAGER_H
+#define SOUNDMANAGER_H
+
+#include <QObject>
+#include <array>
+
+class QSoundEffect;
+
+/**
+ * SoundManager
+ *
+ * Owns a few QSoundEffect voices per sound, all created up front with
+ * their source set. Playing picks an idle voice, or restarts the one
+ * started longest ago when every voice is busy.
+ */
+class SoundManager : public QObject {
+    Q_OBJECT
+
+public:
+    /// Sounds the game can play
+    enum class Sound {
+        Move,      ///< A piece was moved
+        Confetti,  ///< A game or puzzle was won
+        Count
+    };
+
+    /**
+     * Constructor
+     *
+     * Creates every voice and starts loading the samples.
+     *
+     * @param parent Optional parent QObject.
+     */
+    explicit SoundManager(QObject* parent = nullptr);
+
+    /**
+     * play
+     *
+     * Start a sound on a free voice. Does nothing until the sample is loaded.
+     *
+     * @param sound Sound to play.
+     */
+    void play(Sound sound);
+
+    /**
+     * setVolume
+     *
+     * @param volume Linear volume from 0 to 1 for all voices.
+     */
+    void setVolume(float volume);
+
+public slots:
+    /// Convenience slots for signal connections
+    void playMove() { play(Sound::Move); }
+    void playConfetti() { play(Sound::Confetti); }
+
+private:
+    /// Voices per sound; enough for a move and a capture celebration to overlap
+    static constexpr int kVoices = 3;
+    static constexpr int kSounds = int(Sound::Count);
+
+    std::array<std::array<QSoundEffect*, kVoices>, kSounds> voices{};  ///< Preloaded players
+    std::array<int, kSounds> nextVoice{};  ///< Round-robin cursor for stealing
+};
+
+#endif // SOUNDMANAGER_H
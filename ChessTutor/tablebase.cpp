@@ -0,0 +1,1027 @@
+#include "tablebase.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+// The indexing and decompression below follow the reference Syzygy probing
+// code. Squares use the tablebase convention (a1 = 0, h1 = 7, a8 = 56) and
+// pieces its codes: 1-6 = P N B R Q K for white, +8 for black.
+
+enum { TbPawn = 1, TbKnight, TbBishop, TbRook, TbQueen, TbKing };
+enum { TypeWdl = 0, TypeDtz = 1 };
+enum ProbeState { StateFail = 0, StateOk = 1, StateChangeStm = -1, StateZeroing = 2 };
+enum TbFlag { FlagStm = 1, FlagMapped = 2, FlagWinPlies = 4, FlagLossPlies = 8,
+              FlagWide = 16, FlagSingleValue = 128 };
+
+static const int kMaxTbPieces = 7;
+static const int kCacheSize = 4096;
+static const uint8_t kWdlMagic[4]{0x71, 0xE8, 0x23, 0x5D};
+static const uint8_t kDtzMagic[4]{0xD7, 0x66, 0x0C, 0xA5};
+static const char kPieceLetters[] = " PNBRQK";
+
+static int rankOf(int sq){ return sq >> 3; }
+static int fileOf(int sq){ return sq & 7; }
+static int offA1H8(int sq){ return rankOf(sq) - fileOf(sq); }
+
+static uint16_t readLe16(const uint8_t* p){ return uint16_t(p[0] | (p[1] << 8)); }
+static uint32_t readLe32(const uint8_t* p){
+    return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+static uint32_t readBe32(const uint8_t* p){
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+}
+static uint64_t readBe64(const uint8_t* p){
+    return (uint64_t(readBe32(p)) << 32) | readBe32(p + 4);
+}
+
+// ---------------------------------------------------------------------------
+// Encoding tables, built once
+
+static struct Encoding{
+    int mapA1D1D4[64];
+    int mapB1H1H7[64];
+    int mapKK[10][64];
+    int mapPawns[64];
+    int binomial[6][64];
+    int leadPawnIdx[6][64];
+    int leadPawnsSize[6][4];
+
+    Encoding(){
+        std::memset(this, 0, sizeof(*this));
+
+        int code = 0;
+        for (int s = 0; s < 64; s++)
+            if (offA1H8(s) < 0) mapB1H1H7[s] = code++;
+
+        std::vector<int> diagonal;
+        code = 0;
+        for (int s = 0; s <= 27; s++){
+            if (offA1H8(s) < 0 && fileOf(s) <= 3) mapA1D1D4[s] = code++;
+            else if (!offA1H8(s) && fileOf(s) <= 3) diagonal.push_back(s);
+        }
+        for (int s : diagonal) mapA1D1D4[s] = code++;
+
+        // The 462 legal, non-mirrored placements of two kings with the first
+        // in the a1-d1-d4 triangle; both-on-diagonal cases are numbered last.
+        std::vector<std::pair<int, int>> bothOnDiagonal;
+        code = 0;
+        for (int idx = 0; idx < 10; idx++){
+            for (int s1 = 0; s1 <= 27; s1++){
+                if (mapA1D1D4[s1] != idx || (idx == 0 && s1 != 1)) continue;
+                for (int s2 = 0; s2 < 64; s2++){
+                    if (std::abs(rankOf(s1) - rankOf(s2)) <= 1 && std::abs(fileOf(s1) - fileOf(s2)) <= 1)
+                        continue;
+                    if (!offA1H8(s1) && offA1H8(s2) > 0) continue;
+                    if (!offA1H8(s1) && !offA1H8(s2)) bothOnDiagonal.push_back({idx, s2});
+                    else mapKK[idx][s2] = code++;
+                }
+            }
+        }
+        for (auto& p : bothOnDiagonal) mapKK[p.first][p.second] = code++;
+
+        binomial[0][0] = 1;
+        for (int n = 1; n < 64; n++)
+            for (int k = 0; k < 6 && k <= n; k++)
+                binomial[k][n] = (k > 0 ? binomial[k - 1][n - 1] : 0)
+                               + (k < n ? binomial[k][n - 1] : 0);
+
+        // Pawns a2-h7 numbered so the leading pawn (nearest the edge, then
+        // lowest rank) has the highest value.
+        int available = 47;
+        for (int lead = 1; lead <= 5; lead++){
+            for (int f = 0; f <= 3; f++){
+                int idx = 0;
+                for (int r = 1; r <= 6; r++){
+                    int sq = r * 8 + f;
+                    if (lead == 1){
+                        mapPawns[sq] = available--;
+                        mapPawns[sq ^ 7] = available--;
+                    }
+                    leadPawnIdx[lead][sq] = idx;
+                    idx += binomial[lead - 1][mapPawns[sq]];
+                }
+                leadPawnsSize[lead][f] = idx;
+            }
+        }
+    }
+} enc;
+
+// ---------------------------------------------------------------------------
+// Internal position with legal move generation (no castling or en passant)
+
+struct Tablebase::Position{
+    uint8_t piece[64]{}; ///< Tablebase piece code per square, 0 if empty
+    int     stm{0};      ///< 0 white, 1 black
+};
+
+struct TbMove{
+    uint8_t from;
+    uint8_t to;
+    uint8_t promo; ///< Tablebase piece type, 0 if none
+};
+
+static int colorOf(int pc){ return pc >> 3; }
+static int typeOf(int pc){ return pc & 7; }
+
+static bool attacked(const Tablebase::Position& p, int sq, int by){
+    static const int knight[8][2]{{1,2},{2,1},{2,-1},{1,-2},{-1,-2},{-2,-1},{-2,1},{-1,2}};
+    static const int dirs[8][2]{{1,0},{-1,0},{0,1},{0,-1},{1,1},{1,-1},{-1,1},{-1,-1}};
+    int r = rankOf(sq), f = fileOf(sq);
+
+    for (auto& k : knight){
+        int rr = r + k[0], ff = f + k[1];
+        if (rr >= 0 && rr < 8 && ff >= 0 && ff < 8 && p.piece[rr * 8 + ff] == ((by << 3) | TbKnight))
+            return true;
+    }
+    for (int d = 0; d < 8; d++){
+        int rr = r + dirs[d][0], ff = f + dirs[d][1];
+        for (int dist = 1; rr >= 0 && rr < 8 && ff >= 0 && ff < 8; dist++){
+            int pc = p.piece[rr * 8 + ff];
+            if (pc){
+                if (colorOf(pc) == by){
+                    int t = typeOf(pc);
+                    bool straight = d < 4;
+                    if (t == TbQueen || (straight && t == TbRook) || (!straight && t == TbBishop)) return true;
+                    if (dist == 1 && t == TbKing) return true;
+                    // A pawn attacks diagonally forward, i.e. from one rank behind sq
+                    if (dist == 1 && t == TbPawn && !straight && dirs[d][0] == (by == 0 ? -1 : 1)) return true;
+                }
+                break;
+            }
+            rr += dirs[d][0];
+            ff += dirs[d][1];
+        }
+    }
+    return false;
+}
+
+static bool inCheck(const Tablebase::Position& p){
+    for (int s = 0; s < 64; s++)
+        if (p.piece[s] == ((p.stm << 3) | TbKing)) return attacked(p, s, p.stm ^ 1);
+    return false;
+}
+
+static Tablebase::Position doMove(const Tablebase::Position& p, const TbMove& m){
+    Tablebase::Position next = p;
+    next.piece[m.to] = m.promo ? uint8_t((p.stm << 3) | m.promo) : p.piece[m.from];
+    next.piece[m.from] = 0;
+    next.stm = p.stm ^ 1;
+    return next;
+}
+
+static int legalMoves(const Tablebase::Position& p, TbMove* out){
+    static const int knight[8][2]{{1,2},{2,1},{2,-1},{1,-2},{-1,-2},{-2,-1},{-2,1},{-1,2}};
+    static const int dirs[8][2]{{1,0},{-1,0},{0,1},{0,-1},{1,1},{1,-1},{-1,1},{-1,-1}};
+    TbMove pseudo[256];
+    int n = 0;
+    int us = p.stm;
+
+    auto add = [&](int from, int to){
+        bool promotes = typeOf(p.piece[from]) == TbPawn && (rankOf(to) == 7 || rankOf(to) == 0);
+        if (promotes){
+            for (int t = TbQueen; t >= TbKnight; t--) pseudo[n++] = {uint8_t(from), uint8_t(to), uint8_t(t)};
+        }
+        else{
+            pseudo[n++] = {uint8_t(from), uint8_t(to), 0};
+        }
+    };
+
+    for (int s = 0; s < 64; s++){
+        int pc = p.piece[s];
+        if (!pc || colorOf(pc) != us) continue;
+        int r = rankOf(s), f = fileOf(s), t = typeOf(pc);
+
+        if (t == TbPawn){
+            int up = us == 0 ? 1 : -1;
+            int rr = r + up;
+            if (rr < 0 || rr > 7) continue;
+            if (!p.piece[rr * 8 + f]){
+                add(s, rr * 8 + f);
+                int start = us == 0 ? 1 : 6;
+                if (r == start && !p.piece[(rr + up) * 8 + f]) add(s, (rr + up) * 8 + f);
+            }
+            for (int df = -1; df <= 1; df += 2){
+                int ff = f + df;
+                if (ff < 0 || ff > 7) continue;
+                int target = p.piece[rr * 8 + ff];
+                if (target && colorOf(target) != us) add(s, rr * 8 + ff);
+            }
+        }
+        else if (t == TbKnight || t == TbKing){
+            for (int i = 0; i < 8; i++){
+                int rr = r + (t == TbKnight ? knight[i][0] : dirs[i][0]);
+                int ff = f + (t == TbKnight ? knight[i][1] : dirs[i][1]);
+                if (rr < 0 || rr > 7 || ff < 0 || ff > 7) continue;
+                int target = p.piece[rr * 8 + ff];
+                if (!target || colorOf(target) != us) add(s, rr * 8 + ff);
+            }
+        }
+        else{
+            int first = t == TbBishop ? 4 : 0;
+            int last = t == TbRook ? 4 : 8;
+            for (int d = first; d < last; d++){
+                int rr = r + dirs[d][0], ff = f + dirs[d][1];
+                while (rr >= 0 && rr < 8 && ff >= 0 && ff < 8){
+                    int target = p.piece[rr * 8 + ff];
+                    if (target && colorOf(target) == us) break;
+                    add(s, rr * 8 + ff);
+                    if (target) break;
+                    rr += dirs[d][0];
+                    ff += dirs[d][1];
+                }
+            }
+        }
+    }
+
+    int legal = 0;
+    for (int i = 0; i < n; i++){
+        Tablebase::Position next = doMove(p, pseudo[i]);
+        next.stm = us; // check our own king
+        if (!inCheck(next)) out[legal++] = pseudo[i];
+    }
+    return legal;
+}
+
+static bool isZeroing(const Tablebase::Position& p, const TbMove& m){
+    return p.piece[m.to] != 0 || typeOf(p.piece[m.from]) == TbPawn;
+}
+
+static int pieceCount(const Tablebase::Position& p){
+    int n = 0;
+    for (int s = 0; s < 64; s++) if (p.piece[s]) n++;
+    return n;
+}
+
+// Material key: 4 bits per (colour, type); white in the low half.
+static uint64_t materialKey(const int counts[2][7]){
+    uint64_t key = 0;
+    for (int c = 0; c < 2; c++)
+        for (int t = TbPawn; t <= TbKing; t++)
+            key |= uint64_t(counts[c][t]) << (4 * (t - 1) + 24 * c);
+    return key;
+}
+
+static uint64_t materialKey(const Tablebase::Position& p){
+    int counts[2][7]{};
+    for (int s = 0; s < 64; s++)
+        if (p.piece[s]) counts[colorOf(p.piece[s])][typeOf(p.piece[s])]++;
+    return materialKey(counts);
+}
+
+static uint64_t positionKey(const Tablebase::Position& p){
+    static const struct Keys{
+        uint64_t piece[16][64];
+        uint64_t black;
+        Keys(){
+            uint64_t state = 0x53595A5947593031ull;
+            auto next = [&state](){
+                uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+                return z ^ (z >> 31);
+            };
+            for (auto& row : piece) for (auto& k : row) k = next();
+            black = next();
+        }
+    } keys;
+
+    uint64_t key = p.stm ? keys.black : 0;
+    for (int s = 0; s < 64; s++)
+        if (p.piece[s]) key ^= keys.piece[p.piece[s]][s];
+    return key;
+}
+
+static Tablebase::Position fromBoard(const int board[8][8], Player toMove){
+    static const int toTb[7]{0, TbPawn, TbRook, TbKnight, TbBishop, TbQueen, TbKing};
+    Tablebase::Position p;
+    for (int row = 0; row < 8; row++){
+        for (int col = 0; col < 8; col++){
+            int pc = board[row][col];
+            if (!pc) continue;
+            int sq = (7 - row) * 8 + col;
+            p.piece[sq] = uint8_t(toTb[std::abs(pc)] | (pc < 0 ? 8 : 0));
+        }
+    }
+    p.stm = toMove == WHITE ? 0 : 1;
+    return p;
+}
+
+// ---------------------------------------------------------------------------
+// Table layout
+
+struct Tablebase::PairsData{
+    uint8_t  flags{0};
+    uint64_t sizeofBlock{0};
+    uint64_t span{0};
+    uint64_t sparseIndexSize{0};
+    uint32_t numBlocks{0};
+    uint64_t blockLengthSize{0};
+    int      maxSymLen{0};
+    int      minSymLen{0};
+    const uint8_t* lowestSym{nullptr};   ///< uint16 LE per symbol length
+    std::vector<uint64_t> base64;
+    std::vector<uint8_t>  symlen;
+    const uint8_t* btree{nullptr};       ///< 3 bytes (left, right) per symbol
+    const uint8_t* sparseIndex{nullptr}; ///< 6 bytes (block, offset) per entry
+    const uint8_t* blockLength{nullptr}; ///< uint16 LE per block
+    const uint8_t* data{nullptr};
+    uint8_t  pieces[kMaxTbPieces]{};
+    uint64_t groupIdx[kMaxTbPieces + 1]{};
+    int      groupLen[kMaxTbPieces + 1]{};
+    uint16_t mapIdx[4]{};                ///< DTZ value map offsets per WDL
+};
+
+struct Tablebase::Table{
+    QString  path[2];            ///< WDL and DTZ file paths (empty if absent)
+    std::unique_ptr<QFile> file[2];
+    const uint8_t* base[2]{};    ///< Mapped file contents
+    bool     tried[2]{};         ///< Mapping attempted (successfully or not)
+    uint64_t key{0};             ///< Material key, stronger side as white
+    uint64_t key2{0};            ///< Material key with colours swapped
+    int      pieceCount{0};
+    bool     hasPawns{false};
+    bool     hasUniquePieces{false};
+    int      pawnCount[2]{};     ///< Leading colour first
+    PairsData wdl[2][4];         ///< [side to move][lead pawn file]
+    PairsData dtz[4];            ///< [lead pawn file]
+    const uint8_t* dtzMap{nullptr};
+
+    PairsData* get(int type, int stm, int file){
+        int f = hasPawns ? file : 0;
+        return type == TypeWdl ? &wdl[stm % 2][f] : &dtz[f];
+    }
+};
+
+struct Tablebase::CacheEntry{
+    uint64_t key{0};
+    int8_t   wdl{0};
+    int16_t  dtz{0};
+    bool     hasWdl{false};
+    bool     hasDtz{false};
+};
+
+static int setSymlen(Tablebase::PairsData* d, int s, std::vector<bool>& visited){
+    visited[s] = true;
+    const uint8_t* lr = d->btree + 3 * s;
+    int right = (lr[2] << 4) | (lr[1] >> 4);
+    if (right == 0xFFF) return 0;
+    int left = ((lr[1] & 0xF) << 8) | lr[0];
+    if (!visited[left]) d->symlen[left] = uint8_t(setSymlen(d, left, visited));
+    if (!visited[right]) d->symlen[right] = uint8_t(setSymlen(d, right, visited));
+    return d->symlen[left] + d->symlen[right] + 1;
+}
+
+static const uint8_t* setSizes(Tablebase::PairsData* d, const uint8_t* data){
+    d->flags = *data++;
+    if (d->flags & FlagSingleValue){
+        d->numBlocks = 0;
+        d->span = 0;
+        d->blockLengthSize = 0;
+        d->sparseIndexSize = 0;
+        d->minSymLen = *data++; // the single stored value
+        return data;
+    }
+
+    int groups = 0;
+    while (groups < kMaxTbPieces && d->groupLen[groups]) groups++;
+    uint64_t tbSize = d->groupIdx[groups];
+
+    d->sizeofBlock = uint64_t(1) << *data++;
+    d->span = uint64_t(1) << *data++;
+    d->sparseIndexSize = (tbSize + d->span - 1) / d->span;
+    int padding = *data++;
+    d->numBlocks = readLe32(data); data += 4;
+    d->blockLengthSize = d->numBlocks + padding;
+    d->maxSymLen = *data++;
+    d->minSymLen = *data++;
+    d->lowestSym = data;
+    d->base64.assign(d->maxSymLen - d->minSymLen + 1, 0);
+
+    // Canonical Huffman bases: longer codes have lower values.
+    for (int i = int(d->base64.size()) - 2; i >= 0; i--){
+        d->base64[i] = (d->base64[i + 1] + readLe16(d->lowestSym + 2 * i)
+                                         - readLe16(d->lowestSym + 2 * (i + 1))) / 2;
+    }
+    for (size_t i = 0; i < d->base64.size(); i++)
+        d->base64[i] <<= 64 - i - d->minSymLen;
+
+    data += d->base64.size() * 2;
+    d->symlen.assign(readLe16(data), 0); data += 2;
+    d->btree = data;
+
+    std::vector<bool> visited(d->symlen.size());
+    for (size_t s = 0; s < d->symlen.size(); s++)
+        if (!visited[s]) d->symlen[s] = uint8_t(setSymlen(d, int(s), visited));
+
+    return data + d->symlen.size() * 3 + (d->symlen.size() & 1);
+}
+
+static int decompressPairs(const Tablebase::PairsData* d, uint64_t idx){
+    if (d->flags & FlagSingleValue) return d->minSymLen;
+
+    // Find the block holding idx from the nearest sparse index entry
+    uint32_t k = uint32_t(idx / d->span);
+    uint32_t block = readLe32(d->sparseIndex + 6 * k);
+    int offset = readLe16(d->sparseIndex + 6 * k + 4);
+    offset += int(idx % d->span) - int(d->span / 2);
+
+    while (offset < 0) offset += readLe16(d->blockLength + 2 * --block) + 1;
+    while (offset > readLe16(d->blockLength + 2 * block)) offset -= readLe16(d->blockLength + 2 * block++) + 1;
+
+    const uint8_t* ptr = d->data + uint64_t(block) * d->sizeofBlock;
+    uint64_t buf64 = readBe64(ptr); ptr += 8;
+    int buf64Size = 64;
+    int sym;
+
+    for (;;){
+        int len = 0;
+        while (buf64 < d->base64[len]) len++;
+        sym = int((buf64 - d->base64[len]) >> (64 - len - d->minSymLen));
+        sym += readLe16(d->lowestSym + 2 * len);
+        if (offset < d->symlen[sym] + 1) break;
+
+        offset -= d->symlen[sym] + 1;
+        len += d->minSymLen;
+        buf64 <<= len;
+        buf64Size -= len;
+        if (buf64Size <= 32){
+            buf64Size += 32;
+            buf64 |= uint64_t(readBe32(ptr)) << (64 - buf64Size);
+            ptr += 4;
+        }
+    }
+
+    // Expand the pair symbol down to the leaf holding our value
+    while (d->symlen[sym]){
+        const uint8_t* lr = d->btree + 3 * sym;
+        int left = ((lr[1] & 0xF) << 8) | lr[0];
+        if (offset < d->symlen[left] + 1){
+            sym = left;
+        }
+        else{
+            offset -= d->symlen[left] + 1;
+            sym = (lr[2] << 4) | (lr[1] >> 4);
+        }
+    }
+    const uint8_t* lr = d->btree + 3 * sym;
+    return ((lr[1] & 0xF) << 8) | lr[0];
+}
+
+static void setGroups(const Tablebase::Table& e, Tablebase::PairsData* d, const int order[2], int f){
+    int n = 0;
+    int firstLen = e.hasPawns ? 0 : e.hasUniquePieces ? 3 : 2;
+    d->groupLen[n] = 1;
+    for (int i = 1; i < e.pieceCount; i++){
+        if (--firstLen > 0 || d->pieces[i] == d->pieces[i - 1]) d->groupLen[n]++;
+        else d->groupLen[++n] = 1;
+    }
+    d->groupLen[++n] = 0;
+
+    bool pp = e.hasPawns && e.pawnCount[1];
+    int next = pp ? 2 : 1;
+    int freeSquares = 64 - d->groupLen[0] - (pp ? d->groupLen[1] : 0);
+    uint64_t idx = 1;
+
+    for (int k = 0; next < n || k == order[0] || k == order[1]; k++){
+        if (k == order[0]){
+            d->groupIdx[0] = idx;
+            idx *= e.hasPawns ? enc.leadPawnsSize[d->groupLen[0]][f]
+                 : e.hasUniquePieces ? 31332 : 462;
+        }
+        else if (k == order[1]){
+            d->groupIdx[1] = idx;
+            idx *= enc.binomial[d->groupLen[1]][48 - d->groupLen[0]];
+        }
+        else{
+            d->groupIdx[next] = idx;
+            idx *= enc.binomial[d->groupLen[next]][freeSquares];
+            freeSquares -= d->groupLen[next++];
+        }
+    }
+    d->groupIdx[n] = idx;
+}
+
+// ---------------------------------------------------------------------------
+// Tablebase
+
+Tablebase::Tablebase(const QString& directory) : cache(kCacheSize){
+    if (!directory.isEmpty()) setDirectory(directory);
+}
+
+Tablebase::~Tablebase() = default;
+
+int Tablebase::setDirectory(const QString& directory){
+    tables.clear();
+    byKey.clear();
+    std::fill(cache.begin(), cache.end(), CacheEntry{});
+    largest = 0;
+
+    QDir dir(directory);
+    const QStringList files = dir.entryList({"*.rtbw", "*.rtbz"}, QDir::Files, QDir::Name);
+    std::map<QString, Table*> byName;
+
+    for (const QString& name : files){
+        QFileInfo info(name);
+        QString code = info.completeBaseName().toUpper();
+        int type = info.suffix().toLower() == "rtbw" ? TypeWdl : TypeDtz;
+
+        Table* table = byName.count(code) ? byName[code] : nullptr;
+        if (!table){
+            QStringList sides = code.split('V');
+            if (sides.size() != 2 || !sides[0].startsWith('K') || !sides[1].startsWith('K')) continue;
+
+            int counts[2][7]{};
+            bool ok = true;
+            for (int side = 0; side < 2 && ok; side++){
+                for (QChar ch : sides[side]){
+                    const char* at = std::strchr(kPieceLetters + 1, ch.toLatin1());
+                    if (!at || !ch.toLatin1()){ ok = false; break; }
+                    counts[side][at - kPieceLetters]++;
+                }
+            }
+            int total = 0;
+            for (int side = 0; side < 2; side++) for (int t = 1; t < 7; t++) total += counts[side][t];
+            if (!ok || total > kMaxTbPieces) continue;
+
+            auto owned = std::make_unique<Table>();
+            table = owned.get();
+            table->key = materialKey(counts);
+            int swapped[2][7];
+            std::memcpy(swapped[0], counts[1], sizeof(swapped[0]));
+            std::memcpy(swapped[1], counts[0], sizeof(swapped[1]));
+            table->key2 = materialKey(swapped);
+            table->pieceCount = total;
+            table->hasPawns = counts[0][TbPawn] || counts[1][TbPawn];
+            for (int side = 0; side < 2; side++)
+                for (int t = TbPawn; t < TbKing; t++)
+                    if (counts[side][t] == 1) table->hasUniquePieces = true;
+
+            // The leading colour is the side with fewer (but some) pawns
+            bool whiteLeads = !counts[1][TbPawn]
+                || (counts[0][TbPawn] && counts[1][TbPawn] >= counts[0][TbPawn]);
+            table->pawnCount[0] = counts[whiteLeads ? 0 : 1][TbPawn];
+            table->pawnCount[1] = counts[whiteLeads ? 1 : 0][TbPawn];
+
+            byName[code] = table;
+            byKey[table->key] = table;
+            byKey[table->key2] = table;
+            largest = std::max(largest, total);
+            tables.push_back(std::move(owned));
+        }
+        table->path[type] = dir.filePath(name);
+    }
+    return int(tables.size());
+}
+
+bool Tablebase::covers(const int board[8][8]) const {
+    int n = 0;
+    for (int row = 0; row < 8; row++)
+        for (int col = 0; col < 8; col++)
+            if (board[row][col]) n++;
+    return n <= largest;
+}
+
+bool Tablebase::mapTable(Table& e, int type){
+    if (e.tried[type]) return e.base[type] != nullptr;
+    e.tried[type] = true;
+    if (e.path[type].isEmpty()) return false;
+
+    auto file = std::make_unique<QFile>(e.path[type]);
+    if (!file->open(QIODevice::ReadOnly)) return false;
+    qint64 size = file->size();
+    if (size < 16 || size % 64 != 16) return false;
+    const uint8_t* data = file->map(0, size);
+    if (!data) return false;
+    if (std::memcmp(data, type == TypeWdl ? kWdlMagic : kDtzMagic, 4) != 0) return false;
+
+    const uint8_t* p = data + 4;
+    bool split = *p & 1;
+    if (bool(*p & 2) != e.hasPawns || (type == TypeWdl && split != (e.key != e.key2))) return false;
+    p++;
+
+    int sides = type == TypeWdl && e.key != e.key2 ? 2 : 1;
+    int maxFile = e.hasPawns ? 3 : 0;
+    bool pp = e.hasPawns && e.pawnCount[1];
+
+    for (int f = 0; f <= maxFile; f++){
+        for (int i = 0; i < sides; i++) *e.get(type, i, f) = PairsData();
+
+        int order[2][2]{{*p & 0xF, pp ? *(p + 1) & 0xF : 0xF},
+                        {*p >> 4, pp ? *(p + 1) >> 4 : 0xF}};
+        p += 1 + pp;
+
+        for (int k = 0; k < e.pieceCount; k++, p++)
+            for (int i = 0; i < sides; i++)
+                e.get(type, i, f)->pieces[k] = uint8_t(i ? *p >> 4 : *p & 0xF);
+
+        for (int i = 0; i < sides; i++) setGroups(e, e.get(type, i, f), order[i], f);
+    }
+
+    p += (p - data) & 1;
+
+    for (int f = 0; f <= maxFile; f++)
+        for (int i = 0; i < sides; i++)
+            p = setSizes(e.get(type, i, f), p);
+
+    if (type == TypeDtz){
+        e.dtzMap = p;
+        for (int f = 0; f <= maxFile; f++){
+            PairsData* d = e.get(type, 0, f);
+            if (!(d->flags & FlagMapped)) continue;
+            if (d->flags & FlagWide){
+                p += (p - data) & 1;
+                for (int i = 0; i < 4; i++){
+                    d->mapIdx[i] = uint16_t((p - e.dtzMap) / 2 + 1);
+                    p += 2 * readLe16(p) + 2;
+                }
+            }
+            else{
+                for (int i = 0; i < 4; i++){
+                    d->mapIdx[i] = uint16_t(p - e.dtzMap + 1);
+                    p += *p + 1;
+                }
+            }
+        }
+        p += (p - data) & 1;
+    }
+
+    for (int f = 0; f <= maxFile; f++)
+        for (int i = 0; i < sides; i++){
+            PairsData* d = e.get(type, i, f);
+            d->sparseIndex = p;
+            p += d->sparseIndexSize * 6;
+        }
+    for (int f = 0; f <= maxFile; f++)
+        for (int i = 0; i < sides; i++){
+            PairsData* d = e.get(type, i, f);
+            d->blockLength = p;
+            p += d->blockLengthSize * 2;
+        }
+    for (int f = 0; f <= maxFile; f++)
+        for (int i = 0; i < sides; i++){
+            PairsData* d = e.get(type, i, f);
+            p = data + (((p - data) + 0x3F) & ~qint64(0x3F));
+            d->data = p;
+            p += uint64_t(d->numBlocks) * d->sizeofBlock;
+        }
+
+    if (p > data + size) return false;
+    e.file[type] = std::move(file);
+    e.base[type] = data;
+    return true;
+}
+
+int Tablebase::probeTable(const Position& pos, int type, int wdl, int& state){
+    if (pieceCount(pos) == 2) return type == TypeWdl ? Draw : 0; // KvK
+
+    uint64_t key = materialKey(pos);
+    auto it = byKey.find(key);
+    if (it == byKey.end() || !mapTable(*it->second, type)){
+        state = StateFail;
+        return 0;
+    }
+    Table& e = *it->second;
+
+    int squares[kMaxTbPieces];
+    int pieces[kMaxTbPieces];
+    int size = 0;
+    int leadPawnsCnt = 0;
+    uint64_t leadPawns = 0;
+    int tbFile = 0;
+
+    bool symmetricBlackToMove = e.key == e.key2 && pos.stm;
+    bool blackStronger = key != e.key;
+    int flipColor = (symmetricBlackToMove || blackStronger) * 8;
+    int flipSquares = (symmetricBlackToMove || blackStronger) * 56;
+    int stm = (symmetricBlackToMove || blackStronger) ^ pos.stm;
+
+    auto pawnsLess = [](int a, int b){ return enc.mapPawns[a] < enc.mapPawns[b]; };
+
+    if (e.hasPawns){
+        // Lead pawns are of the colour of the first stored piece
+        int pc = e.get(type, 0, 0)->pieces[0] ^ flipColor;
+        for (int s = 0; s < 64; s++){
+            if (pos.piece[s] == pc){
+                leadPawns |= uint64_t(1) << s;
+                squares[size++] = s ^ flipSquares;
+            }
+        }
+        leadPawnsCnt = size;
+        std::swap(squares[0], *std::max_element(squares, squares + leadPawnsCnt, pawnsLess));
+        tbFile = fileOf(squares[0]);
+        if (tbFile > 3) tbFile = fileOf(squares[0] ^ 7);
+    }
+
+    if (type == TypeDtz){
+        int flags = e.get(type, stm, tbFile)->flags;
+        if ((flags & FlagStm) != stm && !(e.key == e.key2 && !e.hasPawns)){
+            state = StateChangeStm;
+            return 0;
+        }
+    }
+
+    for (int s = 0; s < 64; s++){
+        if (!pos.piece[s] || (leadPawns & (uint64_t(1) << s))) continue;
+        squares[size] = s ^ flipSquares;
+        pieces[size++] = pos.piece[s] ^ flipColor;
+    }
+
+    PairsData* d = e.get(type, stm, tbFile);
+
+    // Reorder pieces to the sequence stored in the table
+    for (int i = leadPawnsCnt; i < size - 1; i++){
+        for (int j = i + 1; j < size; j++){
+            if (d->pieces[i] == pieces[j]){
+                std::swap(pieces[i], pieces[j]);
+                std::swap(squares[i], squares[j]);
+                break;
+            }
+        }
+    }
+
+    if (fileOf(squares[0]) > 3)
+        for (int i = 0; i < size; i++) squares[i] ^= 7;
+
+    uint64_t idx;
+    if (e.hasPawns){
+        idx = enc.leadPawnIdx[leadPawnsCnt][squares[0]];
+        std::stable_sort(squares + 1, squares + leadPawnsCnt, pawnsLess);
+        for (int i = 1; i < leadPawnsCnt; i++) idx += enc.binomial[i][enc.mapPawns[squares[i]]];
+    }
+    else{
+        if (rankOf(squares[0]) > 3)
+            for (int i = 0; i < size; i++) squares[i] ^= 56;
+
+        for (int i = 0; i < d->groupLen[0]; i++){
+            if (!offA1H8(squares[i])) continue;
+            if (offA1H8(squares[i]) > 0)
+                for (int j = i; j < size; j++) squares[j] = ((squares[j] >> 3) | (squares[j] << 3)) & 63;
+            break;
+        }
+
+        if (e.hasUniquePieces){
+            int adjust1 = squares[1] > squares[0];
+            int adjust2 = (squares[2] > squares[0]) + (squares[2] > squares[1]);
+
+            if (offA1H8(squares[0]))
+                idx = (uint64_t(enc.mapA1D1D4[squares[0]]) * 63 + (squares[1] - adjust1)) * 62
+                      + squares[2] - adjust2;
+            else if (offA1H8(squares[1]))
+                idx = (6 * 63 + rankOf(squares[0]) * 28 + enc.mapB1H1H7[squares[1]]) * 62
+                      + squares[2] - adjust2;
+            else if (offA1H8(squares[2]))
+                idx = 6 * 63 * 62 + 4 * 28 * 62 + rankOf(squares[0]) * 7 * 28
+                      + (rankOf(squares[1]) - 1) * 28 + enc.mapB1H1H7[squares[2]];
+            else
+                idx = 6 * 63 * 62 + 4 * 28 * 62 + 4 * 7 * 28 + rankOf(squares[0]) * 7 * 6
+                      + (rankOf(squares[1]) - 1) * 6 + (rankOf(squares[2]) - 2);
+        }
+        else{
+            idx = enc.mapKK[enc.mapA1D1D4[squares[0]]][squares[1]];
+        }
+    }
+
+    // Remaining groups, each encoded as a combination of free squares
+    idx *= d->groupIdx[0];
+    int* groupSq = squares + d->groupLen[0];
+    bool remainingPawns = e.hasPawns && e.pawnCount[1];
+    for (int next = 1; d->groupLen[next]; next++){
+        std::stable_sort(groupSq, groupSq + d->groupLen[next]);
+        uint64_t n = 0;
+        for (int i = 0; i < d->groupLen[next]; i++){
+            int adjust = int(std::count_if(squares, groupSq, [&](int s){ return groupSq[i] > s; }));
+            n += enc.binomial[i + 1][groupSq[i] - adjust - 8 * remainingPawns];
+        }
+        remainingPawns = false;
+        idx += n * d->groupIdx[next];
+        groupSq += d->groupLen[next];
+    }
+
+    int value = decompressPairs(d, idx);
+    if (type == TypeWdl) return value - 2;
+
+    // DTZ: map stored value through the per-WDL table and convert to plies
+    static const int wdlMap[5]{1, 3, 0, 2, 0};
+    int flags = d->flags;
+    if (flags & FlagMapped){
+        int at = d->mapIdx[wdlMap[wdl + 2]] + value;
+        value = (flags & FlagWide) ? readLe16(e.dtzMap + 2 * at) : e.dtzMap[at];
+    }
+    if ((wdl == Win && !(flags & FlagWinPlies)) || (wdl == Loss && !(flags & FlagLossPlies))
+        || wdl == CursedWin || wdl == BlessedLoss)
+        value *= 2;
+    return value + 1;
+}
+
+int Tablebase::search(const Position& pos, bool zeroingMoves, int& state){
+    // Tables store "don't care" values where the side to move has a winning
+    // capture, so captures (and for DTZ, pawn moves) are searched explicitly.
+    TbMove moves[256];
+    int total = legalMoves(pos, moves);
+    int count = 0;
+    int best = Loss;
+
+    for (int i = 0; i < total; i++){
+        bool capture = pos.piece[moves[i].to] != 0;
+        if (!capture && (!zeroingMoves || typeOf(pos.piece[moves[i].from]) != TbPawn)) continue;
+        count++;
+        int value = -search(doMove(pos, moves[i]), false, state);
+        if (state == StateFail) return Draw;
+        if (value > best){
+            best = value;
+            if (value >= Win){
+                state = StateZeroing;
+                return value;
+            }
+        }
+    }
+
+    bool noMoreMoves = count && count == total;
+    int value;
+    if (noMoreMoves){
+        value = best;
+    }
+    else{
+        value = probeTable(pos, TypeWdl, Draw, state);
+        if (state == StateFail) return Draw;
+    }
+
+    if (best >= value){
+        state = (best > Draw || noMoreMoves) ? StateZeroing : StateOk;
+        return best;
+    }
+    state = StateOk;
+    return value;
+}
+
+static int dtzBeforeZeroing(int wdl){
+    return wdl == Tablebase::Win ? 1 : wdl == Tablebase::CursedWin ? 101
+         : wdl == Tablebase::BlessedLoss ? -101 : wdl == Tablebase::Loss ? -1 : 0;
+}
+
+static int signOf(int v){ return (v > 0) - (v < 0); }
+
+Tablebase::CacheEntry& Tablebase::cacheSlot(const Position& pos){
+    uint64_t key = positionKey(pos);
+    CacheEntry& slot = cache[key & (kCacheSize - 1)];
+    if (slot.key != key){
+        slot = CacheEntry{};
+        slot.key = key;
+    }
+    return slot;
+}
+
+int Tablebase::probeWdlPosition(const Position& pos, int& state){
+    probes++;
+    CacheEntry& slot = cacheSlot(pos);
+    if (slot.hasWdl){
+        cacheHits++;
+        state = StateOk;
+        return slot.wdl;
+    }
+    state = StateOk;
+    int value = search(pos, false, state);
+    if (state != StateFail){
+        slot.wdl = int8_t(value);
+        slot.hasWdl = true;
+    }
+    return value;
+}
+
+int Tablebase::probeDtzPosition(const Position& pos, int& state){
+    probes++;
+    CacheEntry& slot = cacheSlot(pos);
+    if (slot.hasDtz){
+        cacheHits++;
+        state = StateOk;
+        return slot.dtz;
+    }
+
+    state = StateOk;
+    int wdl = search(pos, true, state);
+    int dtz = 0;
+    if (state == StateFail || wdl == Draw){
+        dtz = 0;
+    }
+    else if (state == StateZeroing){
+        dtz = dtzBeforeZeroing(wdl);
+    }
+    else{
+        dtz = probeTable(pos, TypeDtz, wdl, state);
+        if (state == StateFail) return 0;
+        if (state != StateChangeStm){
+            dtz = (dtz + 100 * (wdl == BlessedLoss || wdl == CursedWin)) * signOf(wdl);
+        }
+        else{
+            // The table stores the other side to move: 1-ply search for the
+            // winning move that minimises DTZ.
+            TbMove moves[256];
+            int total = legalMoves(pos, moves);
+            int minDtz = 0xFFFF;
+            for (int i = 0; i < total; i++){
+                bool zeroing = isZeroing(pos, moves[i]);
+                Position next = doMove(pos, moves[i]);
+                int value;
+                if (zeroing){
+                    int childState = StateOk;
+                    value = -dtzBeforeZeroing(search(next, false, childState));
+                    state = childState;
+                }
+                else{
+                    value = -probeDtzPosition(next, state);
+                }
+                TbMove reply[256];
+                if (value == 1 && inCheck(next) && legalMoves(next, reply) == 0) minDtz = 1;
+                if (!zeroing) value += signOf(value);
+                if (value < minDtz && signOf(value) == signOf(wdl)) minDtz = value;
+                if (state == StateFail) return 0;
+            }
+            dtz = minDtz == 0xFFFF ? -1 : minDtz;
+            state = StateOk;
+        }
+    }
+
+    if (state != StateFail){
+        // A recursive probe may have reused the slot, so look it up again
+        CacheEntry& fresh = cacheSlot(pos);
+        fresh.dtz = int16_t(dtz);
+        fresh.hasDtz = true;
+    }
+    return dtz;
+}
+
+bool Tablebase::probeWdl(const int board[8][8], Player toMove, int& wdl){
+    if (!covers(board)) return false;
+    int state = StateOk;
+    int value = probeWdlPosition(fromBoard(board, toMove), state);
+    if (state == StateFail) return false;
+    wdl = value;
+    return true;
+}
+
+bool Tablebase::probeDtz(const int board[8][8], Player toMove, int& dtz){
+    if (!covers(board)) return false;
+    int state = StateOk;
+    int value = probeDtzPosition(fromBoard(board, toMove), state);
+    if (state == StateFail) return false;
+    dtz = value;
+    return true;
+}
+
+bool Tablebase::bestMove(const int board[8][8], Player toMove, TablebaseMove& move){
+    static const int fromTb[7]{0, PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING};
+    if (!covers(board)) return false;
+
+    Position pos = fromBoard(board, toMove);
+    TbMove moves[256];
+    int total = legalMoves(pos, moves);
+    if (!total) return false;
+
+    int bestRank = -0x7FFFFFFF;
+    for (int i = 0; i < total; i++){
+        Position next = doMove(pos, moves[i]);
+        int state = StateOk;
+        int dtz;
+        int wdl = -probeWdlPosition(next, state);
+        if (state == StateFail) return false;
+
+        if (isZeroing(pos, moves[i])){
+            dtz = dtzBeforeZeroing(wdl);
+        }
+        else{
+            dtz = -probeDtzPosition(next, state);
+            if (state == StateFail) return false;
+            dtz = dtz > 0 ? dtz + 1 : dtz < 0 ? dtz - 1 : dtz;
+        }
+        TbMove reply[256];
+        if (inCheck(next) && dtz == 2 && legalMoves(next, reply) == 0) dtz = 1;
+
+        // Fastest win first, then draws, then the slowest loss
+        int rank = dtz > 0 ? 100000 - dtz : dtz < 0 ? -100000 - dtz : 0;
+        if (rank > bestRank){
+            bestRank = rank;
+            move.fromRow = 7 - rankOf(moves[i].from);
+            move.fromCol = fileOf(moves[i].from);
+            move.toRow = 7 - rankOf(moves[i].to);
+            move.toCol = fileOf(moves[i].to);
+            move.promotion = fromTb[moves[i].promo];
+            move.wdl = wdl;
+            move.dtz = dtz;
+        }
+    }
+    return true;
+}
+
+TablebaseStats Tablebase::stats() const {
+    TablebaseStats s;
+    s.tables = int(tables.size());
+    for (const auto& t : tables)
+        for (int type = 0; type < 2; type++)
+            if (t->base[type]) s.filesMapped++;
+    s.probes = probes;
+    s.cacheHits = cacheHits;
+    return s;
+}
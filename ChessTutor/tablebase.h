@@ -0,0 +1,204 @@
+/*
+ * tablebase.h
+ *
+ * Defines the Tablebase class, which probes Syzygy (WDL/DTZ) endgame
+ * tablebase files from a local directory. Files are memory-mapped the
+ * first time a material combination is probed, and recent probe results
+ * are cached so repeated lookups from search or hinting are free.
+ *
+ * Works fully offline; nothing is fetched or generated at runtime.
+ *
+ * @author  ESL Team
+ * @date    2026-10-16
+ */
+#ifndef TABLEBASE_H
+#define TABLEBASE_H
+
+#include "chess.h"
+#include <QString>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+/**
+ * TablebaseMove
+ *
+ * A move chosen from the tablebase, in board coordinates, with the
+ * outcome it leads to from the mover's point of view.
+ */
+struct TablebaseMove{
+    int fromRow{-1};   ///< Row of source square
+    int fromCol{-1};   ///< Column of source square
+    int toRow{-1};     ///< Row of destination square
+    int toCol{-1};     ///< Column of destination square
+    int promotion{0};  ///< Piece type promoted to (0 for none)
+    int wdl{0};        ///< Outcome after the move, see Tablebase::Wdl
+    int dtz{0};        ///< Plies to the next capture or pawn move (signed like wdl)
+};
+
+/**
+ * TablebaseStats
+ *
+ * Usage counters for a Tablebase.
+ */
+struct TablebaseStats{
+    int      tables{0};      ///< Material combinations found on disk
+    int      filesMapped{0}; ///< Files currently memory-mapped
+    uint64_t probes{0};      ///< Probe requests
+    uint64_t cacheHits{0};   ///< Requests answered from the probe cache
+};
+
+/**
+ * Tablebase
+ *
+ * Syzygy tablebase prober. Positions are given as a Chess-style 8×8 board
+ * plus side to move; castling and en passant rights are assumed absent,
+ * which matches every position the tutor can reach.
+ */
+class Tablebase{
+public:
+    /**
+     * Win/draw/loss values, from the side to move's point of view.
+     * Cursed wins and blessed losses are draws under the 50-move rule.
+     */
+    enum Wdl{
+        Loss        = -2,
+        BlessedLoss = -1,
+        Draw        = 0,
+        CursedWin   = 1,
+        Win         = 2
+    };
+
+    /**
+     * Constructor
+     * @param directory Folder holding .rtbw/.rtbz files (may be empty).
+     */
+    explicit Tablebase(const QString& directory = QString());
+
+    /**
+     * Destructor
+     *
+     * Unmaps every file.
+     */
+    ~Tablebase();
+
+    /**
+     * setDirectory
+     *
+     * Forget all tables and scan a new folder. Nothing is mapped until
+     * a matching position is probed.
+     * @param directory Folder holding .rtbw/.rtbz files
+     * @return Number of material combinations found
+     */
+    int setDirectory(const QString& directory);
+
+    /**
+     * maxPieces
+     *
+     * @return Largest piece count (kings included) covered by the tables.
+     */
+    int maxPieces() const { return largest; }
+
+    /**
+     * covers
+     *
+     * Cheap check that a position has few enough pieces to be probed.
+     * @param board 8×8 board of piece codes
+     */
+    bool covers(const int board[8][8]) const;
+
+    /**
+     * probeWdl
+     *
+     * @param board  8×8 board of piece codes
+     * @param toMove Side to move
+     * @param wdl    Receives the Wdl value on success
+     * @return False if the tables needed are missing or unreadable.
+     */
+    bool probeWdl(const int board[8][8], Player toMove, int& wdl);
+
+    /**
+     * probeDtz
+     *
+     * @param board  8×8 board of piece codes
+     * @param toMove Side to move
+     * @param dtz    Receives plies to the next zeroing move; positive when
+     *               winning, negative when losing, 0 for draws
+     * @return False if the tables needed are missing or unreadable.
+     */
+    bool probeDtz(const int board[8][8], Player toMove, int& dtz);
+
+    /**
+     * bestMove
+     *
+     * Rank every legal move by its tablebase outcome and return the best:
+     * the fastest win, otherwise a draw, otherwise the longest resistance.
+     * @param board  8×8 board of piece codes
+     * @param toMove Side to move
+     * @param move   Receives the chosen move
+     * @return False if there is no legal move or a probe failed.
+     */
+    bool bestMove(const int board[8][8], Player toMove, TablebaseMove& move);
+
+    /**
+     * stats
+     *
+     * @return Table and cache counters.
+     */
+    TablebaseStats stats() const;
+
+    // Internal layout types, defined in tablebase.cpp
+    struct PairsData;
+    struct Table;
+    struct Position;
+    struct CacheEntry;
+
+private:
+    std::vector<std::unique_ptr<Table>> tables;  ///< All tables found on disk
+    std::map<uint64_t, Table*>          byKey;   ///< Material key -> table (both colourings)
+    std::vector<CacheEntry>             cache;   ///< Direct-mapped recent probe results
+    int      largest{0};   ///< Largest piece count covered
+    uint64_t probes{0};    ///< Probe requests
+    uint64_t cacheHits{0}; ///< Requests answered from the cache
+
+    /**
+     * mapTable
+     *
+     * Memory-map and parse a table's WDL or DTZ file on first use.
+     * @return False if the file is missing or malformed.
+     */
+    bool mapTable(Table& table, int type);
+
+    /**
+     * probeTable
+     *
+     * Decode the raw value stored for a position in one file.
+     */
+    int probeTable(const Position& pos, int type, int wdl, int& state);
+
+    /**
+     * search
+     *
+     * Resolve captures (and pawn moves for DTZ) that the tables store as
+     * "don't care" values, then probe the position itself.
+     */
+    int search(const Position& pos, bool zeroingMoves, int& state);
+
+    /**
+     * probeWdlPosition / probeDtzPosition
+     *
+     * Cached WDL and DTZ probes on the internal position type.
+     */
+    int probeWdlPosition(const Position& pos, int& state);
+    int probeDtzPosition(const Position& pos, int& state);
+
+    /**
+     * cacheSlot
+     *
+     * @return Cache entry for a position, cleared if it held another one.
+     */
+    CacheEntry& cacheSlot(const Position& pos);
+};
+
+#endif // TABLEBASE_H
@@ -0,0 +1,15 @@
+QT = core
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = bookbuilder
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    ../../openingbook.cpp \
+    main.cpp
+
+HEADERS += \
+    ../../openingbook.h
@@ -0,0 +1,447 @@
+/*
+ * main.cpp
+ *
+ * bookbuilder: turns local PGN files into a Polyglot opening book keyed
+ * the way OpeningBook reads it.
+ *
+ *   bookbuilder [--plies N] [--min-games N] book.bin games.pgn [more.pgn ...]
+ *
+ * Every game contributes its first N plies (default 20). A move is weighted
+ * 2 per win and 1 per draw for the side that played it, the Polyglot
+ * convention, and kept if it was played in at least --min-games games.
+ * Castling is written in the Polyglot king-takes-rook form. En passant and
+ * promotions are followed so later positions are right, but are not
+ * written since the tutor cannot play them.
+ *
+ * @author  ESL Team
+ * @date    2026-10-16
+ */
+#include "openingbook.h"
+#include <QFile>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using std::cerr;
+using std::cout;
+using std::endl;
+
+/**
+ * Game
+ *
+ * Board state while replaying one PGN game.
+ */
+struct Game{
+    int board[8][8];
+    Player toMove{WHITE};
+    int epRow{-1}; ///< En passant target square, -1 if none
+    int epCol{-1};
+    int plies{0};  ///< Half-moves played so far
+
+    void reset(){
+        static const int start[8][8]{
+            {-ROOK,-KNIGHT,-BISHOP,-QUEEN,-KING,-BISHOP,-KNIGHT,-ROOK},
+            {-PAWN,-PAWN,-PAWN,-PAWN,-PAWN,-PAWN,-PAWN,-PAWN},
+            {}, {}, {}, {},
+            {PAWN, PAWN, PAWN, PAWN, PAWN, PAWN, PAWN, PAWN},
+            {ROOK, KNIGHT, BISHOP, QUEEN, KING, BISHOP, KNIGHT, ROOK},
+        };
+        std::copy(&start[0][0], &start[0][0] + 64, &board[0][0]);
+        toMove = WHITE;
+        epRow = epCol = -1;
+        plies = 0;
+    }
+};
+
+/**
+ * PlayedMove
+ *
+ * A book candidate recorded while replaying a game.
+ */
+struct PlayedMove{
+    uint64_t key;
+    uint16_t move;
+    Player   side;
+};
+
+/**
+ * MoveStats
+ *
+ * Accumulated results for one (position, move) pair.
+ */
+struct MoveStats{
+    uint32_t score{0}; ///< 2 per win, 1 per draw
+    uint32_t games{0}; ///< Games the move was played in
+};
+
+static bool onBoard(int row, int col){
+    return row >= 0 && row < 8 && col >= 0 && col < 8;
+}
+
+static bool attacked(const int board[8][8], int row, int col, Player by){
+    int sign = by == WHITE ? 1 : -1;
+
+    // Pawns attack toward the opponent; a white pawn sits one row below.
+    int pawnRow = row + (by == WHITE ? 1 : -1);
+    for (int dc = -1; dc <= 1; dc += 2){
+        if (onBoard(pawnRow, col + dc) && board[pawnRow][col + dc] == sign * PAWN) return true;
+    }
+
+    static const int knight[8][2]{{1,2},{2,1},{-1,2},{-2,1},{1,-2},{2,-1},{-1,-2},{-2,-1}};
+    for (const auto& d : knight){
+        int r = row + d[0], c = col + d[1];
+        if (onBoard(r, c) && board[r][c] == sign * KNIGHT) return true;
+    }
+
+    for (int dr = -1; dr <= 1; dr++){
+        for (int dc = -1; dc <= 1; dc++){
+            if (!dr && !dc) continue;
+            int r = row + dr, c = col + dc;
+            if (onBoard(r, c) && board[r][c] == sign * KING) return true;
+
+            bool diagonal = dr && dc;
+            for (; onBoard(r, c); r += dr, c += dc){
+                int piece = board[r][c];
+                if (!piece) continue;
+                if (piece == sign * QUEEN
+                    || piece == sign * (diagonal ? BISHOP : ROOK)) return true;
+                break;
+            }
+        }
+    }
+    return false;
+}
+
+static bool reaches(const int board[8][8], int type, int fr, int fc, int tr, int tc){
+    int dr = tr - fr, dc = tc - fc;
+    switch (type){
+    case KNIGHT:
+        return (std::abs(dr) == 1 && std::abs(dc) == 2) || (std::abs(dr) == 2 && std::abs(dc) == 1);
+    case KING:
+        return std::max(std::abs(dr), std::abs(dc)) == 1;
+    case BISHOP:
+    case ROOK:
+    case QUEEN: {
+        bool diagonal = std::abs(dr) == std::abs(dc) && dr;
+        bool straight = (dr == 0) != (dc == 0);
+        if ((type == BISHOP && !diagonal) || (type == ROOK && !straight)
+            || (type == QUEEN && !diagonal && !straight)) return false;
+        int sr = (dr > 0) - (dr < 0), sc = (dc > 0) - (dc < 0);
+        for (int r = fr + sr, c = fc + sc; r != tr || c != tc; r += sr, c += sc){
+            if (board[r][c]) return false;
+        }
+        return true;
+    }
+    }
+    return false;
+}
+
+static int kingRow(const int board[8][8], Player side, int& kingCol){
+    for (int r = 0; r < 8; r++){
+        for (int c = 0; c < 8; c++){
+            if (board[r][c] == side * KING){ kingCol = c; return r; }
+        }
+    }
+    kingCol = -1;
+    return -1;
+}
+
+static bool leavesKingSafe(const Game& game, int fr, int fc, int tr, int tc, bool enPassant){
+    int board[8][8];
+    std::copy(&game.board[0][0], &game.board[0][0] + 64, &board[0][0]);
+    board[tr][tc] = board[fr][fc];
+    board[fr][fc] = 0;
+    if (enPassant) board[fr][tc] = 0;
+
+    int kc;
+    int kr = kingRow(board, game.toMove, kc);
+    return kr < 0 || !attacked(board, kr, kc, Player(-game.toMove));
+}
+
+/**
+ * playSan
+ *
+ * Resolve and play one SAN move.
+ * @param bookable Set if the move goes in the book (no en passant or
+ *                 promotion)
+ * @param move     Receives the encoded move when bookable
+ * @return False if the move is malformed or illegal here.
+ */
+static bool playSan(Game& game, std::string san, bool& bookable, uint16_t& move){
+    while (!san.empty() && std::string("+#!?").find(san.back()) != std::string::npos) san.pop_back();
+    bookable = false;
+
+    int home = game.toMove == WHITE ? 7 : 0;
+    if (san == "O-O" || san == "0-0" || san == "O-O-O" || san == "0-0-0"){
+        bool longSide = san.size() == 5;
+        if (game.board[home][4] != game.toMove * KING) return false;
+        int rookFrom = longSide ? 0 : 7;
+        game.board[home][longSide ? 2 : 6] = game.board[home][4];
+        game.board[home][longSide ? 3 : 5] = game.board[home][rookFrom];
+        game.board[home][4] = 0;
+        game.board[home][rookFrom] = 0;
+        bookable = true;
+        move = OpeningBook::encodeMove(home, 4, home, longSide ? 2 : 6, KING);
+        game.epRow = game.epCol = -1;
+        game.toMove = Player(-game.toMove);
+        game.plies++;
+        return true;
+    }
+
+    int promotion = 0;
+    std::size_t eq = san.find('=');
+    if (eq != std::string::npos){
+        if (eq + 1 >= san.size()) return false;
+        promotion = int(std::string(" PRNBQK").find(san[eq + 1]));
+        if (promotion < ROOK || promotion > QUEEN) return false;
+        san.erase(eq);
+    }
+    else if (san.size() > 2 && std::string("QRBN").find(san.back()) != std::string::npos
+             && std::isdigit(static_cast<unsigned char>(san[san.size() - 2]))){
+        promotion = int(std::string(" PRNBQK").find(san.back()));
+        san.pop_back();
+    }
+
+    int type = PAWN;
+    std::size_t pos = std::string("KQRBN").find(san.empty() ? ' ' : san[0]);
+    if (!san.empty() && pos != std::string::npos){
+        static const int kTypes[5]{KING, QUEEN, ROOK, BISHOP, KNIGHT};
+        type = kTypes[pos];
+        san.erase(0, 1);
+    }
+    san.erase(std::remove(san.begin(), san.end(), 'x'), san.end());
+    if (san.size() < 2) return false;
+
+    int tc = san[san.size() - 2] - 'a';
+    int tr = 8 - (san[san.size() - 1] - '0');
+    if (!onBoard(tr, tc)) return false;
+
+    int needCol = -1, needRow = -1;
+    for (std::size_t i = 0; i + 2 < san.size(); i++){
+        if (san[i] >= 'a' && san[i] <= 'h') needCol = san[i] - 'a';
+        else if (san[i] >= '1' && san[i] <= '8') needRow = 8 - (san[i] - '0');
+        else return false;
+    }
+
+    int target = game.board[tr][tc];
+    if (target && (target > 0) == (game.toMove == WHITE)) return false;
+
+    int piece = game.toMove * type;
+    int forward = game.toMove == WHITE ? -1 : 1;
+    int fr = -1, fc = -1, found = 0;
+    bool enPassant = false;
+
+    for (int r = 0; r < 8; r++){
+        for (int c = 0; c < 8; c++){
+            if (game.board[r][c] != piece) continue;
+            if ((needCol >= 0 && c != needCol) || (needRow >= 0 && r != needRow)) continue;
+
+            bool ok, ep = false;
+            if (type == PAWN){
+                if (c == tc){
+                    int start = game.toMove == WHITE ? 6 : 1;
+                    ok = !target && (tr == r + forward
+                         || (r == start && tr == r + 2 * forward && !game.board[r + forward][c]));
+                }
+                else{
+                    ep = !target && tr == game.epRow && tc == game.epCol;
+                    ok = std::abs(c - tc) == 1 && tr == r + forward && (target || ep);
+                }
+            }
+            else{
+                ok = reaches(game.board, type, r, c, tr, tc);
+            }
+            if (!ok || !leavesKingSafe(game, r, c, tr, tc, ep)) continue;
+
+            fr = r; fc = c; enPassant = ep;
+            found++;
+        }
+    }
+    if (found != 1) return false;
+
+    bookable = !enPassant && !promotion;
+    move = OpeningBook::encodeMove(fr, fc, tr, tc, piece);
+
+    game.board[tr][tc] = promotion ? game.toMove * promotion : piece;
+    game.board[fr][fc] = 0;
+    if (enPassant) game.board[fr][tc] = 0;
+
+    game.epRow = game.epCol = -1;
+    if (type == PAWN && std::abs(tr - fr) == 2){
+        game.epRow = fr + forward;
+        game.epCol = fc;
+    }
+    game.toMove = Player(-game.toMove);
+    game.plies++;
+    return true;
+}
+
+static void writeBigEndian(char* out, uint64_t value, int bytes){
+    for (int i = bytes - 1; i >= 0; i--){
+        out[i] = char(value & 0xFF);
+        value >>= 8;
+    }
+}
+
+int main(int argc, char* argv[]){
+    int maxPlies = 20;
+    int minGames = 1;
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; i++){
+        std::string arg = argv[i];
+        if (arg == "--plies" && i + 1 < argc) maxPlies = std::atoi(argv[++i]);
+        else if (arg == "--min-games" && i + 1 < argc) minGames = std::atoi(argv[++i]);
+        else paths.push_back(arg);
+    }
+    if (paths.size() < 2){
+        cerr << "usage: bookbuilder [--plies N] [--min-games N] book.bin games.pgn [more.pgn ...]" << endl;
+        return 2;
+    }
+
+    std::map<uint64_t, std::map<uint16_t, MoveStats>> book;
+    int games = 0, broken = 0;
+
+    for (std::size_t p = 1; p < paths.size(); p++){
+        QFile in(QString::fromStdString(paths[p]));
+        if (!in.open(QIODevice::ReadOnly)){
+            cerr << "cannot read " << paths[p] << endl;
+            return 1;
+        }
+        const std::string text = in.readAll().toStdString();
+
+        Game game;
+        game.reset();
+        std::vector<PlayedMove> played;
+        std::string result;
+        bool inMoves = false, failed = false;
+
+        auto finishGame = [&](const std::string& outcome){
+            if (inMoves){
+                games++;
+                if (failed) broken++;
+                for (const PlayedMove& m : played){
+                    MoveStats& s = book[m.key][m.move];
+                    s.games++;
+                    if (outcome == "1/2-1/2") s.score += 1;
+                    else if ((outcome == "1-0" && m.side == WHITE) || (outcome == "0-1" && m.side == BLACK)) s.score += 2;
+                }
+            }
+            game.reset();
+            played.clear();
+            result.clear();
+            inMoves = failed = false;
+        };
+
+        std::size_t i = 0;
+        while (i < text.size()){
+            char ch = text[i];
+            if (std::isspace(static_cast<unsigned char>(ch))){ i++; continue; }
+
+            if (ch == '['){
+                // A tag after movetext without a result token starts a new game
+                if (inMoves) finishGame(result);
+                std::size_t end = text.find(']', i);
+                std::string tag = text.substr(i, end == std::string::npos ? std::string::npos : end - i);
+                if (tag.compare(0, 8, "[Result ") == 0){
+                    std::size_t q1 = tag.find('"'), q2 = tag.rfind('"');
+                    if (q1 != std::string::npos && q2 > q1) result = tag.substr(q1 + 1, q2 - q1 - 1);
+                }
+                i = end == std::string::npos ? text.size() : end + 1;
+                continue;
+            }
+            if (ch == '{'){
+                std::size_t end = text.find('}', i);
+                i = end == std::string::npos ? text.size() : end + 1;
+                continue;
+            }
+            if (ch == ';'){
+                std::size_t end = text.find('\n', i);
+                i = end == std::string::npos ? text.size() : end + 1;
+                continue;
+            }
+            if (ch == '('){
+                int depth = 0;
+                for (; i < text.size(); i++){
+                    if (text[i] == '(') depth++;
+                    else if (text[i] == ')' && --depth == 0){ i++; break; }
+                }
+                continue;
+            }
+
+            std::size_t start = i;
+            while (i < text.size() && !std::isspace(static_cast<unsigned char>(text[i]))
+                   && text[i] != '{' && text[i] != '(' && text[i] != ';') i++;
+            std::string token = text.substr(start, i - start);
+
+            if (token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*"){
+                inMoves = true;
+                finishGame(token);
+                continue;
+            }
+            if (token[0] == '$') continue;
+
+            // Drop a leading move number ("12." or "12...")
+            std::size_t digits = 0;
+            while (digits < token.size() && std::isdigit(static_cast<unsigned char>(token[digits]))) digits++;
+            if (digits && digits < token.size() && token[digits] == '.'){
+                token.erase(0, digits);
+                token.erase(0, token.find_first_not_of('.'));
+            }
+            if (token.empty()) continue;
+
+            inMoves = true;
+            if (failed || game.plies >= maxPlies) continue;
+
+            uint64_t key = OpeningBook::positionKey(game.board, game.toMove);
+            Player side = game.toMove;
+            bool bookable;
+            uint16_t move;
+            if (!playSan(game, token, bookable, move)){
+                failed = true;
+                continue;
+            }
+            if (bookable) played.push_back({key, move, side});
+        }
+        finishGame(result);
+    }
+
+    // Flatten, then scale weights into 16 bits if a move is very popular
+    struct Entry{ uint64_t key; uint16_t move; uint32_t weight; };
+    std::vector<Entry> entries;
+    uint32_t largest = 0;
+    for (const auto& position : book){
+        for (const auto& m : position.second){
+            if (int(m.second.games) < minGames || m.second.score == 0) continue;
+            entries.push_back({position.first, m.first, m.second.score});
+            largest = std::max(largest, m.second.score);
+        }
+    }
+    double scale = largest > 0xFFFF ? double(0xFFFF) / largest : 1.0;
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b){
+        return a.key != b.key ? a.key < b.key : a.weight > b.weight;
+    });
+
+    QFile out(QString::fromStdString(paths[0]));
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate)){
+        cerr << "cannot write " << paths[0] << endl;
+        return 1;
+    }
+    for (const Entry& e : entries){
+        char raw[OpeningBook::kEntrySize]{};
+        writeBigEndian(raw, e.key, 8);
+        writeBigEndian(raw + 8, e.move, 2);
+        writeBigEndian(raw + 10, std::max<uint32_t>(1, uint32_t(e.weight * scale)), 2);
+        out.write(raw, sizeof raw);
+    }
+
+    cout << games << " games (" << broken << " with unreadable moves), "
+         << book.size() << " positions, " << entries.size() << " entries written to "
+         << paths[0] << endl;
+    return 0;
+}
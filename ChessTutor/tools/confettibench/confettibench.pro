@@ -0,0 +1,46 @@
+QT += core gui widgets svg
+greaterThan(QT_MAJOR_VERSION, 5): QT += opengl openglwidgets
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = confettibench
+
+INCLUDEPATH += ../..
+
+# The board widget hosts the controller, so it and what it links come along
+SOURCES += \
+    $$files(../../Box2D/*.cpp, true) \
+    ../../assetmanager.cpp \
+    ../../chess.cpp \
+    ../../chessboard.cpp \
+    ../../confetticontroller.cpp \
+    ../../effectlibrary.cpp \
+    ../../evaluation.cpp \
+    ../../frameclock.cpp \
+    ../../glboardview.cpp \
+    ../../openingbook.cpp \
+    ../../particleemitter.cpp \
+    ../../particlekernel.cpp \
+    ../../particlesystem.cpp \
+    ../../pawnhash.cpp \
+    ../../pieceset.cpp \
+    ../../qualitygovernor.cpp \
+    ../../tablebase.cpp \
+    main.cpp
+
+HEADERS += \
+    ../../assetmanager.h \
+    ../../chess.h \
+    ../../chessboard.h \
+    ../../confetticontroller.h \
+    ../../effectlibrary.h \
+    ../../frameclock.h \
+    ../../glboardview.h \
+    ../../particleemitter.h \
+    ../../particlekernel.h \
+    ../../particlesystem.h \
+    ../../qualitygovernor.h
+
+RESOURCES += \
+    ../../Asset.qrc
@@ -0,0 +1,186 @@
+/*
+ * main.cpp
+ *
+ * confettibench: times the confetti path headlessly, phase by phase, so
+ * regressions show up and the simulation backends can be compared on the
+ * same machine.
+ *
+ *   confettibench [--counts 100,1000,10000,100000] [--steps N]
+ *                 [--backend box2d|particles|both] [--effect NAME]
+ *                 [--size PX] [--seed N] [--format csv|json]
+ *
+ * For every backend and particle count, one burst of the effect (default
+ * "solve") is spawned into an empty controller, then N fixed 1/60 s steps
+ * (default 120) are simulated, culled and drawn into an offscreen QImage.
+ * Spawn is the time for the burst; step, cull and draw are averages per
+ * step. Results go to stdout, one row or object per run.
+ *
+ * @author  ESL Team
+ * @date    2026-10-16
+ */
+#include "chessboard.h"
+#include "confetticontroller.h"
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QPainter>
+#include <QResizeEvent>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using std::cerr;
+using std::cout;
+using std::endl;
+
+/**
+ * Result
+ *
+ * Timings of one backend at one particle count, in milliseconds.
+ */
+struct Result{
+    std::string backend;
+    int requested{0};   ///< Particles asked for
+    std::size_t live{0};///< Particles actually spawned
+    double spawn{0};    ///< The burst
+    double step{0};     ///< Per step
+    double cull{0};     ///< Per step
+    double draw{0};     ///< Per step
+};
+
+static double msSince(const QElapsedTimer& t){
+    return t.nsecsElapsed() / 1e6;
+}
+
+static Result run(ChessBoard& board, ConfettiController::Backend backend, const QString& effect,
+                  int count, int steps, std::uint64_t seed){
+    ConfettiController confetti(&board);
+    confetti.setBackend(backend);
+    confetti.setCapacity(std::size_t(count));
+    confetti.seed(seed);
+
+    Result r;
+    r.backend = backend == ConfettiController::Backend::Box2D ? "box2d" : "particles";
+    r.requested = count;
+
+    QElapsedTimer t;
+    t.start();
+    // Where celebrate() starts; the frame clock play() wakes never runs here
+    confetti.play(effect, b2Vec2(4.0f, 12.0f), count);
+    r.spawn = msSince(t);
+    r.live = confetti.particleCount();
+
+    QImage target(board.size(), QImage::Format_ARGB32_Premultiplied);
+    const float dt = 1.0f / 60.0f;
+    for (int i = 0; i < steps; i++){
+        t.restart();
+        confetti.simulate(dt);
+        r.step += msSince(t);
+
+        t.restart();
+        confetti.cull();
+        r.cull += msSince(t);
+
+        target.fill(Qt::transparent);
+        QPainter painter(&target);
+        t.restart();
+        confetti.draw(painter);
+        painter.end();
+        r.draw += msSince(t);
+    }
+    if (steps > 0){
+        r.step /= steps;
+        r.cull /= steps;
+        r.draw /= steps;
+    }
+    return r;
+}
+
+int main(int argc, char* argv[]){
+    // No display needed unless the caller picked a platform
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+
+    std::vector<int> counts{100, 1000, 10000, 100000};
+    int steps = 120;
+    int size = 800;
+    std::uint64_t seed = 1;
+    std::string backendArg = "both";
+    std::string format = "csv";
+    QString effect = "solve";
+
+    for (int i = 1; i < argc; i++){
+        std::string arg = argv[i];
+        if (arg == "--counts" && i + 1 < argc){
+            counts.clear();
+            std::stringstream list(argv[++i]);
+            std::string item;
+            while (std::getline(list, item, ','))
+                if (std::atoi(item.c_str()) > 0) counts.push_back(std::atoi(item.c_str()));
+        }
+        else if (arg == "--steps" && i + 1 < argc) steps = std::atoi(argv[++i]);
+        else if (arg == "--backend" && i + 1 < argc) backendArg = argv[++i];
+        else if (arg == "--effect" && i + 1 < argc) effect = QString::fromLocal8Bit(argv[++i]);
+        else if (arg == "--size" && i + 1 < argc) size = std::atoi(argv[++i]);
+        else if (arg == "--seed" && i + 1 < argc) seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--format" && i + 1 < argc) format = argv[++i];
+        else{
+            cerr << "usage: confettibench [--counts 100,1000,...] [--steps N] [--backend box2d|particles|both]"
+                    " [--effect NAME] [--size PX] [--seed N] [--format csv|json]" << endl;
+            return 2;
+        }
+    }
+
+    std::vector<ConfettiController::Backend> backends;
+    if (backendArg == "box2d" || backendArg == "both") backends.push_back(ConfettiController::Backend::Box2D);
+    if (backendArg == "particles" || backendArg == "both") backends.push_back(ConfettiController::Backend::Particles);
+    if (backends.empty() || counts.empty() || (format != "csv" && format != "json")){
+        cerr << "nothing to run" << endl;
+        return 2;
+    }
+
+    // The board is never shown; deliver the resize so its layout is set
+    ChessBoard board;
+    board.resize(size, size);
+    QResizeEvent resize(board.size(), QSize());
+    QApplication::sendEvent(&board, &resize);
+
+    {
+        ConfettiController probe(&board);
+        if (!probe.effects().find(effect)){
+            cerr << "no effect named " << effect.toStdString() << endl;
+            return 1;
+        }
+    }
+
+    std::vector<Result> results;
+    for (auto backend : backends){
+        for (int count : counts){
+            results.push_back(run(board, backend, effect, count, steps, seed));
+            const Result& r = results.back();
+            cerr << r.backend << " " << r.requested << ": step " << r.step << " ms" << endl;
+        }
+    }
+
+    if (format == "csv"){
+        cout << "backend,particles,live,spawn_ms,step_ms,cull_ms,draw_ms" << endl;
+        for (const Result& r : results)
+            cout << r.backend << ',' << r.requested << ',' << r.live << ',' << r.spawn << ','
+                 << r.step << ',' << r.cull << ',' << r.draw << endl;
+    }
+    else{
+        cout << "[" << endl;
+        for (std::size_t i = 0; i < results.size(); i++){
+            const Result& r = results[i];
+            cout << "  {\"backend\": \"" << r.backend << "\", \"particles\": " << r.requested
+                 << ", \"live\": " << r.live << ", \"spawn_ms\": " << r.spawn
+                 << ", \"step_ms\": " << r.step << ", \"cull_ms\": " << r.cull
+                 << ", \"draw_ms\": " << r.draw << "}" << (i + 1 < results.size() ? "," : "") << endl;
+        }
+        cout << "]" << endl;
+    }
+    return 0;
+}
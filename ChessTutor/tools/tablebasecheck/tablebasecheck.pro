@@ -0,0 +1,15 @@
+QT = core
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = tablebasecheck
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    ../../tablebase.cpp \
+    main.cpp
+
+HEADERS += \
+    ../../tablebase.h